@@ -0,0 +1,59 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ALINHAMENTO_ARENA 64   // Toda reserva começa em uma linha de cache
+#define MAX_RESERVAS_ARENA 512 // Reservas acompanhadas para a devolução individual
+
+// Arena da ordenação: um único bloco, do tamanho do plano de memória do método, do qual saem
+// as áreas temporárias (heaps, amostras, histogramas, buffers das fitas e de E/S, vetores de
+// corridas). Uma reserva só avança um deslocamento; em vez de liberar cada área, o método marca
+// a arena no início de uma fase e a restaura ao final dela, quando nada reservado na fase
+// continua em uso.
+// Fora de uma ordenação (arena inativa) ou quando a arena se esgota, alocar_temporario recorre
+// ao malloc e liberar_temporario ao free, de modo que as rotinas funcionam com ou sem arena.
+// As reservas vão para a arena corrente: a da ordenação do processo ou, com usar_arena, a de
+// um contexto da biblioteca (ver libordena.h).
+
+typedef struct Arena Arena;
+
+// Ativa a arena da ordenação, vazia; até o primeiro dimensionar_arena, as reservas vão para o
+// malloc. O bloco da ordenação anterior é reaproveitado se for grande o bastante.
+void ativar_arena(void);
+
+// Limita a arena corrente a 'bytes' bytes (o plano de memória do método). Vazia, a arena troca
+// o bloco por um desse tamanho se o atual for menor; com reservas em uso, o bloco não muda de
+// lugar e o limite fica no que ele comporta.
+void dimensionar_arena(long bytes);
+
+// Esvazia e desativa a arena da ordenação, mantendo o bloco para a próxima
+void desativar_arena(void);
+
+// Devolve o bloco da arena da ordenação ao sistema (a arena precisa estar inativa)
+void liberar_arena(void);
+
+// Arena própria, já ativa, com um bloco de 'bytes' bytes reservado na criação; retorna NULL
+// se faltar memória
+Arena *criar_arena(long bytes);
+void destruir_arena(Arena *arena);
+
+// Torna 'arena' a arena corrente (NULL: a da ordenação) e retorna a anterior
+Arena *usar_arena(Arena *arena);
+
+// Reserva 'bytes' bytes alinhados a ALINHAMENTO_ARENA; retorna NULL se faltar memória
+void *alocar_temporario(size_t bytes);
+
+// Libera uma área de alocar_temporario. Dentro da arena, as reservas voltam a ficar disponíveis
+// de imediato na ordem inversa à de reserva; uma reserva liberada fora dessa ordem volta junto
+// com a que estava depois dela, ou na restauração da marca da fase.
+void liberar_temporario(void *p);
+
+// Marca o ponto atual da arena e, depois, libera tudo o que foi reservado desde a marca
+long marcar_arena(void);
+void restaurar_arena(long marca);
+
+// Maior ocupação da arena corrente, limite em bytes e reservas atendidas pelo malloc desde a ativação
+void consultar_arena(long *pico, long *tamanho, long *fora);
+
+#endif // ARENA_H
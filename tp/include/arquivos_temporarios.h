@@ -0,0 +1,65 @@
+#ifndef ARQUIVOS_TEMPORARIOS_H
+#define ARQUIVOS_TEMPORARIOS_H
+
+#include <stddef.h>
+
+#define DIRETORIO_TEMPORARIO_PADRAO "./data" // Mesmo sistema de arquivos das saídas: a fita final vira a saída sem cópia
+#define TAM_CAMINHO_TEMPORARIO 32            // Espaço para o caminho de caminho_arquivo_temporario
+
+// Gerenciador dos arquivos temporários dos métodos (fitas da intercalação, fitas de etiquetas,
+// baldes da amostragem). Os arquivos são criados sem nome (O_TMPFILE, ou mkstemp seguido de
+// unlink onde o sistema de arquivos não o suporta) no diretório temporário: duas ordenações
+// simultâneas no mesmo diretório nunca usam o mesmo arquivo, e nada sobra no disco se o
+// processo terminar no meio. Um arquivo devolvido é truncado e reaproveitado pela próxima
+// reserva, em vez de fechado e criado de novo a cada passada.
+
+// Diretório onde os arquivos temporários são criados (ex.: um tmpfs); vale para as reservas seguintes
+void definir_diretorio_temporario(const char *diretorio);
+const char *diretorio_temporario(void);
+
+// Reserva um arquivo temporário vazio e retorna seu identificador. Encerra o programa se
+// o arquivo não puder ser criado.
+int reservar_arquivo_temporario(void);
+
+// Reserva um arquivo temporário vazio em 'diretorio' (NULL: o diretório temporário); retorna
+// -1 em vez de encerrar o programa se o arquivo não puder ser criado (usada pela libordena)
+int tentar_reservar_arquivo_temporario(const char *diretorio);
+
+// Trunca o arquivo e o deixa livre para a próxima reserva
+void devolver_arquivo_temporario(int id);
+
+// Descritor do arquivo (as fitas abertas sobre ele usam uma cópia com dup)
+int descritor_arquivo_temporario(int id);
+
+// Caminho (/proc/self/fd/N) pelo qual o arquivo pode ser aberto por nome enquanto está reservado,
+// inclusive pelos processos filhos que herdam o descritor. Os métodos preparam a saída em um
+// temporário aberto assim e só o exportam para o destino no fim, de modo que execuções
+// simultâneas nunca escrevem no mesmo arquivo.
+void caminho_arquivo_temporario(int id, char *caminho, size_t tamanho);
+
+// Atualiza a contabilidade de disco com o tamanho atual do arquivo (chamado ao fechar uma fita)
+void registrar_uso_arquivo_temporario(int id);
+
+// Torna o arquivo temporário o arquivo 'destino' e o devolve: cria um nome para ele quando
+// está no mesmo sistema de arquivos (linkat) e, caso contrário, copia o conteúdo. Se 'destino'
+// é o caminho de outro temporário reservado por este processo, esse passa a ser o arquivo.
+void exportar_arquivo_temporario(int id, const char *destino);
+
+// Destino da saída dos métodos: o arquivo pedido (--saida) ou, se NULL, o ARQUIVO_SAIDA_* de cada um
+void definir_destino_saida(const char *destino);
+const char *destino_saida(const char *padrao);
+
+// Reserva o temporário em que um método prepara sua saída e preenche o seu caminho
+// (TAM_CAMINHO_TEMPORARIO bytes); retorna o identificador
+int preparar_saida(char *caminho);
+
+// Exporta a saída preparada para destino_saida(padrao) e retorna esse nome
+const char *concluir_saida(int arquivo, const char *padrao);
+
+// Zera o pico de uso de disco e a contagem de arquivos criados (início de uma ordenação)
+void reiniciar_uso_temporarios(void);
+
+// Arquivos criados, bytes em uso agora e maior soma de bytes em uso desde reiniciar_uso_temporarios
+void consultar_arquivos_temporarios(long *criados, long *bytes, long *pico);
+
+#endif // ARQUIVOS_TEMPORARIOS_H
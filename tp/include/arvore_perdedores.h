@@ -0,0 +1,42 @@
+#ifndef ARVORE_PERDEDORES_H
+#define ARVORE_PERDEDORES_H
+
+#define FAN_IN_MAXIMO 64 // Limite de fontes intercaladas de uma vez (limita também os arquivos abertos)
+#define BYTES_FOLHA_ARVORE (2 * sizeof(int) + sizeof(float)) // Memória da árvore por fonte
+
+// Compara as chaves correntes das fontes x e y: negativo se x vem antes, positivo se vem depois
+// e 0 se empatam
+typedef int (*ComparadorFontes)(int x, int y, void *dados);
+
+// Árvore de perdedores (árvore de torneio) para intercalação de k fontes.
+// Cada nó interno guarda a fonte que perdeu a disputa naquele nó; a raiz (arvore[0])
+// guarda a vencedora. Trocar a chave da vencedora custa apenas log2(k) comparações.
+typedef struct {
+    int k;             // Número de fontes
+    int ordem;         // ORDEM_ASCENDENTE ou ORDEM_DESCENDENTE
+    int *arvore;       // arvore[0]: vencedora; arvore[1..k-1]: perdedoras de cada nó interno
+    float *chaves;     // Chave corrente de cada fonte
+    int *ativa;        // 0 se a fonte esgotou (perde para qualquer fonte ativa)
+    long *desempate;   // Chave secundária de cada fonte, sempre crescente (NULL: desempata pelo índice)
+    ComparadorFontes comparar; // Compara as fontes no lugar de 'chaves' e 'ordem' (NULL: as chaves float)
+    void *dados;       // Repassado a 'comparar'
+    long *comparacoes;  // Contador de comparações a incrementar (pode ser NULL)
+} ArvorePerdedores;
+
+ArvorePerdedores *criar_arvore_perdedores(int k, int ordem, long *comparacoes);
+void liberar_arvore_perdedores(ArvorePerdedores *arv);
+
+// Reconstrói a árvore a partir das chaves e estados já definidos em 'chaves' e 'ativa'
+void construir_arvore_perdedores(ArvorePerdedores *arv);
+
+// Retorna a fonte vencedora, ou -1 se todas as fontes estão inativas
+int vencedora_arvore_perdedores(const ArvorePerdedores *arv);
+
+// Atualiza a chave (ou o estado) da fonte vencedora e refaz o caminho até a raiz
+void atualizar_arvore_perdedores(ArvorePerdedores *arv, int fonte, float chave, int ativa);
+
+// Escolhe o fan-in da intercalação a partir do orçamento de registros em memória
+// (um registro por fonte) e do número estimado de corridas
+int calcular_fan_in(int tam_memoria, long num_corridas);
+
+#endif // ARVORE_PERDEDORES_H
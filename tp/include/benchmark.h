@@ -0,0 +1,19 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#define MAX_VALORES_BENCH 16       // Valores por lista de parâmetros (métodos, quantidades...)
+#define MAX_REPETICOES_BENCH 1000  // Execuções medidas por configuração
+#define REPETICOES_PADRAO 5
+#define AQUECIMENTO_PADRAO 1
+
+// Subcomando de benchmark: ordena bench [opções]
+// Percorre todas as combinações de método x ordem da entrada x quantidade x situação x bloco x orçamento
+// de memória.
+// Cada execução roda em um processo filho (as saídas dos métodos são descartadas e o estado
+// global de uma execução não vaza para a próxima); as métricas voltam ao processo principal
+// por um pipe. Antes de cada execução o cache de páginas é descartado quando possível.
+// Uma linha CSV é escrita por configuração: mediana e p95 do tempo de parede, vazão e
+// número de passadas sobre os dados (leituras de registros / N).
+int executar_benchmark(int argc, char *argv[]);
+
+#endif // BENCHMARK_H
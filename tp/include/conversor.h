@@ -0,0 +1,26 @@
+#ifndef CONVERSOR_H
+#define CONVERSOR_H
+
+#define ARQUIVO_PROVAO "./data/PROVAO.TXT" // Arquivo texto original, em colunas de largura fixa
+
+// Colunas do PROVAO.TXT (posição inicial e largura de cada campo na linha)
+#define COL_INSCRICAO 0
+#define LARG_INSCRICAO 8
+#define COL_NOTA 9
+#define LARG_NOTA 5
+#define COL_ESTADO 15
+#define LARG_ESTADO 2
+#define COL_CIDADE 18
+#define LARG_CIDADE 50
+#define COL_CURSO 69
+#define LARG_CURSO 30
+
+// Converte o arquivo texto para o formato binário de registros usado pelos métodos.
+// O texto é mapeado em memória e dividido em trechos (um por núcleo, quebrados em fim de linha)
+// que são interpretados em paralelo; cada trecho grava seus registros direto na posição final
+// do arquivo binário (após o cabeçalho). Linhas com inscrição inválida são ignoradas, como em ler_provao.
+// Converte no máximo 'quantidade' registros (todos, se quantidade <= 0).
+// Retorna o número de registros gravados.
+long converter_provao(const char *nome_texto, const char *nome_binario, long quantidade);
+
+#endif // CONVERSOR_H
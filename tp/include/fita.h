@@ -0,0 +1,112 @@
+#ifndef FITA_H
+#define FITA_H
+
+#include <stdint.h>
+#include "registro.h"
+
+#define FITA_LEITURA 0
+#define FITA_ESCRITA 1
+
+#define TAM_BLOCO_PADRAO (64 * 1024) // Tamanho padrão do bloco de E/S, em bytes
+
+// Fita: arquivo de registros acessado em blocos de tamanho configurável.
+// Os registros são transferidos entre o arquivo e um buffer próprio com uma única
+// chamada read/write por bloco, em vez de um fread/fwrite por registro.
+// Uma fita pode percorrer o arquivo do início para o fim ou, no modo reverso,
+// do fim para o início (usado nas extremidades superiores do quicksort externo).
+// Uma fita de itens (abrir_fita_itens) guarda itens de outro tamanho, como as etiquetas.
+typedef struct {
+    int fd;               // Descritor do arquivo (-1 se a fita lê de um arquivo mapeado)
+    int modo;             // FITA_LEITURA ou FITA_ESCRITA
+    int reverso;          // 1 se percorre o arquivo em posições decrescentes
+    Registro *bloco;      // Buffer de um bloco (aponta para o mapeamento se a fita é mapeada)
+    int tam_item;         // Bytes por item: sizeof(Registro), exceto nas fitas de itens
+    const Registro *mapa; // Registros do arquivo mapeado (NULL se a fita usa read/write)
+    long total_mapa;      // Registros disponíveis no mapeamento
+    int capacidade;       // Itens por bloco
+    int pos;              // Próxima posição a usar no buffer
+    int n;                // Registros válidos no buffer (leitura)
+    long proximo;         // Leitura: próximo registro a carregar; escrita: registro associado ao
+                          // início do buffer (ou ao fim dele, no modo reverso)
+    long restantes;       // Leitura: registros que ainda podem ser carregados (-1: até o fim do arquivo)
+    long *contador_blocos; // Contador de blocos transferidos a incrementar (pode ser NULL)
+    long base;            // Deslocamento em bytes do primeiro registro (cabeçalho; 0 em arquivos legados)
+    int cabecalho;        // 1 se a fita grava o cabeçalho ao ser fechada (arquivo criado por abrir_fita)
+    long escritos;        // Registros gravados (para o cabeçalho)
+    uint64_t soma;        // Soma de verificação dos registros gravados
+    int temporario;       // Arquivo do gerenciador de temporários (-1: arquivo comum)
+} Fita;
+
+// Define o tamanho do bloco usado pelas fitas abertas a partir de então
+void definir_tamanho_bloco(int bytes);
+// Idem, para o bloco derivado pelo plano de memória: não o marca como definido, e o próximo
+// plano volta a derivá-lo
+void ajustar_tamanho_bloco(int bytes);
+int tamanho_bloco_atual(void);
+int bloco_definido(void); // 1 se o bloco já foi definido (--bloco ou plano de memória)
+int registros_por_bloco(void);
+int itens_por_bloco(int tam_item); // Itens de 'tam_item' bytes que cabem em um bloco
+long bytes_fita(int tam_item);      // Memória de uma fita de itens de 'tam_item' bytes: estrutura e bloco
+
+// Abre uma fita para percorrer o arquivo desde o início. A escrita trunca o arquivo e,
+// ao fechar a fita, grava o cabeçalho com a quantidade e a soma de verificação dos registros.
+Fita *abrir_fita(const char *nome, int modo, long *contador_blocos);
+
+// Abre uma fita posicionada no registro 'inicio' sem truncar o arquivo (nem alterar o cabeçalho); no modo reverso,
+// 'inicio' é o primeiro registro visitado e as posições seguintes são decrescentes
+Fita *abrir_fita_em(const char *nome, int modo, long inicio, int reverso, long *contador_blocos);
+
+// Abre uma fita sobre um arquivo do gerenciador de temporários (ver arquivos_temporarios.h), desde o
+// início; como em abrir_fita, a escrita trunca o arquivo e grava o cabeçalho ao fechar a fita
+Fita *abrir_fita_temporaria(int arquivo, int modo, long *contador_blocos);
+
+// Abre para leitura uma fita sobre um arquivo do gerenciador de temporários, posicionada no
+// registro 'inicio' (uma corrida no meio do arquivo)
+Fita *abrir_fita_temporaria_em(int arquivo, long inicio, long *contador_blocos);
+
+// Abre uma fita de itens de 'tam_item' bytes sobre um arquivo do gerenciador de temporários,
+// desde o início e sem cabeçalho (a escrita só trunca o arquivo). Os itens são transferidos
+// com ler_item_fita e escrever_item_fita.
+Fita *abrir_fita_itens(int arquivo, int modo, int tam_item, long *contador_blocos);
+
+// Limita a leitura aos próximos 'quantidade' registros (evita carregar blocos fora do intervalo)
+void limitar_fita(Fita *f, long quantidade);
+
+// Modo de entrada mapeada: quando ativo, abrir_fita_entrada lê o arquivo direto do
+// mapeamento em memória (zero cópia para o buffer da fita e nenhuma chamada read)
+void definir_entrada_mapeada(int ativa);
+int entrada_mapeada_ativa(void);
+
+// Abre a fita de leitura da entrada de um método, mapeada ou não conforme o modo atual
+Fita *abrir_fita_entrada(const char *nome, long *contador_blocos);
+
+// Fita mapeada: devolve um ponteiro para os próximos até n registros, sem copiá-los,
+// e avança a fita. Retorna NULL no fim. Em fitas comuns, retorna NULL sempre.
+const Registro *espiar_registros_fita(Fita *f, int n, int *obtidos);
+
+// Lê o próximo registro; retorna 1 se leu e 0 no fim da fita
+int ler_fita(Fita *f, Registro *r);
+
+// Lê até n registros consecutivos; retorna quantos foram lidos
+int ler_registros_fita(Fita *f, Registro *v, int n);
+
+void escrever_fita(Fita *f, const Registro *r);
+void escrever_registros_fita(Fita *f, const Registro *v, int n);
+
+// Lê ou grava o próximo item de uma fita de itens; ler_item_fita retorna 0 no fim da fita
+int ler_item_fita(Fita *f, void *item);
+void escrever_item_fita(Fita *f, const void *item);
+
+// Descarrega o buffer pendente (escrita), fecha o arquivo e libera a fita
+void fechar_fita(Fita *f);
+
+// Fecha o arquivo e libera a fita sem gravar o buffer pendente nem o cabeçalho (conteúdo descartado)
+void descartar_fita(Fita *f);
+
+// Rotina chamada com a mensagem de erro quando uma operação de fita falha. Ela não deve
+// retornar (a libordena volta ao ponto de entrada da chamada com longjmp). Sem tratador, o
+// erro é impresso com perror e o programa é encerrado. Retorna o tratador anterior.
+typedef void (*TratadorErroFita)(const char *mensagem);
+TratadorErroFita definir_tratador_erro_fita(TratadorErroFita tratador);
+
+#endif // FITA_H
@@ -0,0 +1,42 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <stdint.h>
+
+// Distribuições das notas geradas
+#define DIST_ORDENADA 0   // Notas crescentes ao longo do arquivo
+#define DIST_INVERSA 1    // Notas decrescentes ao longo do arquivo
+#define DIST_ALEATORIA 2  // Uniforme sobre todo o domínio de notas
+#define DIST_DUPLICADAS 3 // Uniforme sobre poucos valores distintos
+#define DIST_ZIPF 4       // Poucos valores muito frequentes e uma cauda longa de valores raros
+#define DIST_RUIDO 5      // Ordenada, com uma porcentagem dos registros fora do lugar
+
+#define NOTA_MAXIMA 100         // Notas no intervalo [0, NOTA_MAXIMA], como no PROVAO.TXT
+#define MAX_CASAS_GERADOR 3     // Casas decimais tratadas pelo gerador
+#define TAM_BUFFER_GERACAO (4 * 1024 * 1024) // Registros gerados por gravação, em bytes, por thread
+#define MIN_REGISTROS_TRECHO (64 * 1024)     // Trechos menores não compensam uma thread a mais
+
+typedef struct {
+    int distribuicao;  // DIST_*
+    uint64_t semente;  // O arquivo gerado depende só da semente e dos parâmetros (não das threads)
+    int casas;         // Casas decimais das notas (0 a MAX_CASAS_GERADOR)
+    long distintos;    // Valores distintos em DIST_DUPLICADAS e DIST_ZIPF
+    double expoente;   // Expoente da distribuição de Zipf
+    double ruido;      // Porcentagem de registros fora do lugar em DIST_RUIDO
+    int threads;       // Threads de geração (0: uma por núcleo)
+} ParametrosGerador;
+
+// Preenche os parâmetros padrão: aleatória, semente 42, uma casa decimal, 10 valores distintos,
+// expoente 1.0 e 5% de ruído
+void iniciar_parametros_gerador(ParametrosGerador *p);
+
+// Converte o nome de uma distribuição em DIST_*; retorna -1 se o nome é desconhecido
+int distribuicao_por_nome(const char *nome);
+
+// Grava 'quantidade' registros sintéticos (ids 1..quantidade) no arquivo binário, com cabeçalho.
+// O arquivo é dividido em trechos contíguos gravados em paralelo, um por thread, cada um com
+// pwrite direto na posição final. Cada registro é gerado a partir de um hash da semente e da sua
+// posição, de modo que o resultado não depende do número de threads.
+void gerar_registros(const char *nome_binario, long quantidade, const ParametrosGerador *p);
+
+#endif // GERADOR_H
@@ -0,0 +1,39 @@
+#ifndef GRAVACAO_PARALELA_H
+#define GRAVACAO_PARALELA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "registro.h"
+#include "leitura.h"
+
+// Gravação paralela de um arquivo binário de registros (conversor e gerador): o arquivo é
+// dividido em trechos, um por thread, e cada trecho grava seus registros com pwrite direto na
+// posição final. O cabeçalho é gravado vazio na criação e completado com a quantidade e a
+// soma de verificação depois que todas as threads terminam.
+
+// Saída de um trecho. Deve ser o primeiro campo da estrutura de trecho de quem a usa, para que
+// executar_trechos e finalizar_binario_paralelo percorram vetores dessas estruturas.
+typedef struct {
+    int fd;        // Arquivo binário de saída
+    long destino;  // Posição (em registros) da próxima gravação
+    uint64_t soma; // Soma de verificação dos registros gravados pelo trecho
+} TrechoBinario;
+
+// Número de trechos: um por thread pedida (ou por núcleo, se threads <= 0), sem passar de um
+// trecho a cada 'minimo' unidades de 'tamanho'; sempre ao menos um
+int contar_trechos(long tamanho, long minimo, int threads);
+
+// Executa a função sobre cada um dos 'num_trechos' elementos (de 'tam_trecho' bytes) do vetor, um por thread
+void executar_trechos(void *trechos, int num_trechos, size_t tam_trecho, void *(*funcao)(void *));
+
+// Grava 'n' registros na posição de destino do trecho (após o cabeçalho), acumula a soma e avança o destino
+void gravar_trecho(TrechoBinario *t, const Registro *v, long n);
+
+// Cria (ou trunca) o arquivo binário e grava um cabeçalho vazio; retorna o descritor
+int criar_binario_paralelo(const char *nome_binario, CabecalhoArquivo *cabecalho);
+
+// Reescreve o cabeçalho com a quantidade e a soma dos trechos e fecha o arquivo
+void finalizar_binario_paralelo(int fd, CabecalhoArquivo *cabecalho, long quantidade,
+                                const void *trechos, int num_trechos, size_t tam_trecho);
+
+#endif // GRAVACAO_PARALELA_H
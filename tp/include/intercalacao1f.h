@@ -3,10 +3,13 @@
 
 #include "registro.h"
 #include "leitura.h"
+#include "utils.h"
 
 #define MAX_REGISTROS_1F 10  // Correção para 10 registros na memória
-#define NUM_FITAS_1F 20      // 10 fitas de entrada + 10 fitas de saída
+#define NUM_FITAS_1F 20      // Limite de fitas em disco (até NUM_FITAS_1F - 1 de entrada + 1 de saída)
 
-void intercalacao_balanceada_1f(const char *arquivo, int n, int situacao);
+#define ARQUIVO_SAIDA_1F "./data/saida_1f.bin" // Arquivo ordenado produzido pelo método
+
+void intercalacao_balanceada_1f(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
 
 #endif // INTERCALACAO1F_H
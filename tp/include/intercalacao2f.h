@@ -1,14 +1,78 @@
 #ifndef INTERCALACAO2F_H
 #define INTERCALACAO2F_H
 
+#include <stdio.h>
 #include "registro.h"
 #include "utils.h"
+#include "arvore_perdedores.h"
+#include "fita.h"
+
+// Modos de geração das corridas iniciais
+#define CORRIDAS_AUTOMATICO 0 // Radix por blocos se a memória comporta LIMIAR_RADIX_CORRIDAS registros
+#define CORRIDAS_HEAP 1       // Seleção por substituição (corridas de ~2M registros)
+#define CORRIDAS_RADIX 2      // Ordenação radix de blocos cheios (corridas de M registros, tempo linear)
+#define LIMIAR_RADIX_CORRIDAS 4096
+
+#define ARQUIVO_SAIDA_2F "./data/saida_2f.bin" // Arquivo ordenado produzido pelo método
 
 typedef struct {
     float nota;    // Nota do registro
     long posicao;  // Posição original no vetor de registros
 } NotaPosicao;
 
+// Estrutura para o heap de seleção por substituição
+// Cada nó do heap contém uma nota, a posição original do registro e o ciclo a que pertence
+typedef struct {
+    float nota;          // Nota do registro (valor usado para ordenação)
+    long posicao;        // Posição original no vetor de registros (para recuperar o registro completo depois)
+    int ciclo;           // Número da corrida (ciclo) a que o elemento pertence (usado para separar as corridas)
+} HeapNode;
+
+// Constantes que definem a ordem de ordenação
+#define ORDEM_ASCENDENTE 0  // Para ordenar do menor para o maior
+#define ORDEM_DESCENDENTE 1 // Para ordenar do maior para o menor
+
+// Ordem pedida pela situação da linha de comando, a mesma em todos os métodos:
+// 2 é descendente; 1 e 3 são ascendentes
+int ordem_da_situacao(int situacao);
+
+// Estado de uma fita de entrada durante a intercalação
+typedef struct {
+    Fita *fita;        // Fita em disco lida em blocos
+    Registro atual;    // Registro lido e ainda não intercalado
+    int tem_registro;  // 1 se 'atual' é válido (a fita não terminou)
+    int ativa;         // 1 se a fita ainda participa da corrida sendo intercalada
+    long restantes;    // Registros que faltam da corrida atual (-1: a corrida termina numa quebra de ordem)
+} EstadoFita;
+
+// Funções do heap de seleção por substituição (compartilhadas com a intercalação F+1)
+void descer_no_heap(HeapNode *heap, int i, int n, int ordem);
+void construir_heap(HeapNode *heap, int n, int ordem);
+
+// Geração de corridas e intercalação sobre fitas em disco (compartilhadas com a intercalação F+1)
+int quebra_ordem(float anterior, float prox, int ordem);
+int selecao_por_substituicao(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                             int tam_memoria, Metricas *stats, int ordem);
+int corridas_por_radix(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                       int tam_memoria, Metricas *stats, int ordem);
+void definir_modo_corridas(int modo);
+int corridas_por_selecao(int tam_memoria); // 1 se gerar_corridas usará a seleção por substituição
+const char *nome_corridas(int tam_memoria); // Geração de corridas em uso, para o nome do método no relatório
+int gerar_corridas(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                   int tam_memoria, Metricas *stats, int ordem);
+void avancar_fita(EstadoFita *f, Metricas *stats);
+long intercalar_corridas(EstadoFita *fitas, int num_fitas, Fita *saida, ArvorePerdedores *arv,
+                         Metricas *stats, int ordem);
+int intercalar_fitas(Fita **entradas, int num_entradas, Fita **saidas, int num_saidas,
+                     long *tamanhos, Metricas *stats, int ordem);
+int distribuir_corridas_naturais(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                                 long *tamanhos, Metricas *stats, int ordem);
+
+// Intercalação natural em 2F fitas: distribui as 'corridas' corridas naturais da entrada e as
+// intercala até restar uma, gravando o resultado em 'destino'
+void intercalacao_natural(const char *nome_arquivo, const char *destino, int quantidade,
+                          long corridas, Metricas *stats, int ordem);
+
 void intercalacao_balanceada_2f_ascendente(const char *nome_arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
 void intercalacao_balanceada_2f_descendente(const char *nome_arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
 #endif // INTERCALACAO2F_H
\ No newline at end of file
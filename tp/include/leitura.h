@@ -2,7 +2,12 @@
 #define LEITURA_H
 
 #include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "registro.h"
+#include "utils.h"
+
+#define ARQUIVO_REGISTROS "./data/registros.bin" // Arquivo binário de entrada dos métodos
 
 FILE *abrir_arquivo(const char *nome, const char *modo);
 void fechar_arquivo(FILE *arquivo);
@@ -11,8 +16,78 @@ void trim_string(char *str);
 // Nova função para ler o arquivo PROVAO.TXT
 void ler_provao(const char *nome_arquivo, Registro **registros, int quantidade, int situacao);
 
-void ler_binario(const char *nome_binario, 
-  Registro **registros, 
-  int quantidade);
+#define TAM_BUFFER_IMPRESSAO (1024 * 1024) // Maior buffer de saída de imprimir_binario, em bytes
+
+// Imprime todos os registros do arquivo no formato de print_registro
+void imprimir_binario(const char *nome_binario);
+
+// Arquivo binário mapeado em memória: os registros são acessados direto do cache de páginas,
+// sem cópia para um vetor alocado
+typedef struct {
+    const Registro *registros; // Início dos registros mapeados (NULL se o arquivo está vazio)
+    long quantidade;           // Registros disponíveis no arquivo
+    size_t tamanho;            // Tamanho mapeado, em bytes (inclui o cabeçalho)
+    size_t inicio;             // Bytes antes do primeiro registro (cabeçalho, se houver)
+    char nome[256];            // Arquivo mapeado
+} ArquivoMapeado;
+
+// Cabeçalho dos arquivos binários de registros (versão 1). Ocupa exatamente a posição de um
+// registro no início do arquivo, de modo que os blocos continuam alinhados a registros.
+// Arquivos sem cabeçalho (formato legado) continuam sendo lidos normalmente.
+#define CABECALHO_MAGICA "TPED2REG"
+#define CABECALHO_VERSAO 1
+#define TAM_CABECALHO ((long)sizeof(Registro))
+
+#define CHAVE_NENHUMA 0 // Arquivo sem ordenação conhecida
+#define CHAVE_NOTA 1    // Arquivo ordenado pela nota
+
+typedef struct {
+    char magica[8];              // CABECALHO_MAGICA, sem terminador
+    uint32_t versao;             // CABECALHO_VERSAO
+    uint32_t tam_cabecalho;      // Bytes antes do primeiro registro
+    uint32_t tam_registro;       // sizeof(Registro) de quem gravou o arquivo
+    uint32_t deslocamento_chave; // offsetof(Registro, nota) de quem gravou o arquivo
+    uint32_t chave;              // CHAVE_NENHUMA ou CHAVE_NOTA
+    int32_t ordem;               // ORDEM_ASCENDENTE ou ORDEM_DESCENDENTE (se chave == CHAVE_NOTA)
+    int64_t quantidade;          // Registros no arquivo
+    uint64_t soma;               // Soma de verificação dos registros (ver soma_registros)
+} CabecalhoArquivo;
+
+// Soma de verificação: soma dos hashes de cada registro. Não depende da ordem dos registros,
+// então a saída ordenada de um método tem a mesma soma que a entrada correspondente.
+uint64_t soma_registros(const Registro *v, long n);
+
+// Preenche um cabeçalho de arquivo não ordenado e vazio
+void iniciar_cabecalho(CabecalhoArquivo *c);
+
+// Lê o cabeçalho de um arquivo aberto; retorna 1 se há cabeçalho e 0 se o arquivo é legado.
+// Encerra o programa se o cabeçalho é de uma versão ou layout de registro incompatível.
+int ler_cabecalho(int fd, CabecalhoArquivo *c);
+void escrever_cabecalho(int fd, const CabecalhoArquivo *c);
+int gravar_cabecalho(int fd, const CabecalhoArquivo *c); // Como escrever_cabecalho, mas retorna 0 na falha
+
+// Consulta o cabeçalho de um arquivo pelo nome. Para arquivos legados, preenche um cabeçalho
+// equivalente (quantidade pelo tamanho do arquivo, sem ordenação conhecida) e retorna 0.
+int consultar_binario(const char *nome_binario, CabecalhoArquivo *c);
+
+// Registra no cabeçalho que o arquivo está ordenado pela nota na ordem indicada
+void marcar_ordenado(const char *nome_binario, int ordem);
+
+// Se o cabeçalho indica que a entrada já está ordenada pela nota na ordem pedida, copia os
+// primeiros 'quantidade' registros para a saída (uma passada sequencial, contada no
+// pré-processamento) e retorna 1; caso contrário, retorna 0 sem fazer nada
+int copiar_se_ordenado(const char *origem, const char *destino, int quantidade, int ordem, Metricas *stats);
+
+// Imprime o cabeçalho de um arquivo e confere a soma de verificação; retorna 0 se confere
+int verificar_binario(const char *nome_binario);
+
+// Copia o conteúdo inteiro do arquivo aberto em 'fd_origem' para 'destino' (criado ou truncado),
+// um bloco de fita por vez
+void copiar_binario_descritor(int fd_origem, const char *destino);
+
+// Mapeia o arquivo uma única vez por processo; chamadas seguintes com o mesmo nome
+// reaproveitam o mapeamento. Aplica os conselhos de acesso sequencial e pré-carga (madvise).
+const ArquivoMapeado *mapear_binario(const char *nome_binario);
+void desmapear_binario(void);
 
 #endif // LEITURA_H
\ No newline at end of file
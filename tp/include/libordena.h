@@ -0,0 +1,72 @@
+#ifndef LIBORDENA_H
+#define LIBORDENA_H
+
+#include "registro.h"
+
+// Biblioteca de ordenação embutível (libordena.a / libordena.so, make lib): em vez de chamar o
+// programa e ler a saída, a aplicação insere registros em um contexto, finaliza e extrai os
+// registros já ordenados, sem passar pelos arquivos de entrada e saída dos métodos.
+// Uma falha de E/S nas fitas temporárias não encerra o programa: a chamada retorna
+// ORDENA_ERRO_ARQUIVO e o contexto passa a aceitar só ordena_reiniciar e ordena_destruir.
+
+#ifndef ORDEM_ASCENDENTE
+#define ORDEM_ASCENDENTE 0  // Mesmos valores de intercalacao2f.h
+#define ORDEM_DESCENDENTE 1
+#endif
+
+// Códigos de retorno da biblioteca
+#define ORDENA_OK 0
+#define ORDENA_ERRO_MEMORIA -1  // Falha de alocação
+#define ORDENA_ERRO_ESTADO -2   // Chamada fora de ordem (inserir depois de finalizar, extrair antes...)
+#define ORDENA_ERRO_ARQUIVO -3  // Falha ao criar, gravar ou ler os arquivos temporários das corridas
+
+#define MEMORIA_PADRAO_LIB (64L * 1024 * 1024) // Orçamento de um contexto sem --mem, em bytes
+
+// Extrai a chave de ordenação de um registro ('dados' é o ponteiro dado nas opções)
+typedef double (*ExtratorChave)(const Registro *r, void *dados);
+
+// Compara duas chaves: negativo se 'a' vem antes de 'b', positivo se vem depois e 0 se empatam
+typedef int (*ComparadorChave)(double a, double b, void *dados);
+
+typedef struct {
+    int ordem;                // ORDEM_ASCENDENTE ou ORDEM_DESCENDENTE (só com o comparador padrão)
+    ExtratorChave extrair;    // NULL: a nota do registro
+    ComparadorChave comparar; // NULL: ordem numérica das chaves no sentido de 'ordem'
+    void *dados;              // Repassado ao extrator e ao comparador
+    long memoria;             // Orçamento do contexto em bytes (0: o de --mem ou MEMORIA_PADRAO_LIB)
+    const char *diretorio;    // Diretório das corridas (NULL: o de definir_diretorio_temporario)
+} OpcoesOrdena;
+
+// Contexto de uma ordenação (opaco)
+typedef struct ContextoOrdenacao ContextoOrdenacao;
+
+// Preenche as opções padrão: ordem ascendente pela nota, memória e diretório padrão
+void iniciar_opcoes_ordena(OpcoesOrdena *opcoes);
+
+// Cria um contexto de ordenação; retorna NULL se faltar memória. O contexto reserva de uma vez
+// uma arena do tamanho do orçamento, da qual saem a área de trabalho e as fitas das corridas.
+// As opções são copiadas (o diretório, não: a string deve viver tanto quanto o contexto).
+ContextoOrdenacao *ordena_criar(const OpcoesOrdena *opcoes);
+
+// Acrescenta n registros à ordenação. Quando a área de trabalho enche, o conteúdo é
+// ordenado e gravado como uma corrida em um arquivo temporário.
+int ordena_inserir(ContextoOrdenacao *ctx, const Registro *registros, long n);
+
+// Encerra a inserção. Se tudo coube na memória, os registros são ordenados ali mesmo (sem
+// arquivos); senão, as corridas são intercaladas até restarem no máximo as que o orçamento
+// permite abrir de uma vez, e a última intercalação acontece durante a extração.
+int ordena_finalizar(ContextoOrdenacao *ctx);
+
+// Copia para 'destino' até 'max' registros seguintes na ordem pedida; retorna quantos
+// foram copiados (0 no fim) ou um código de erro negativo. Registros de chaves iguais saem
+// na ordem em que foram inseridos.
+long ordena_extrair(ContextoOrdenacao *ctx, Registro *destino, long max);
+
+// Descarta os registros e volta à inserção, mantendo os buffers já alocados para a próxima
+// ordenação (as opções são mantidas); também recupera o contexto depois de ORDENA_ERRO_ARQUIVO
+void ordena_reiniciar(ContextoOrdenacao *ctx);
+
+// Libera o contexto e devolve os arquivos temporários (criados sem nome, nada fica no disco)
+void ordena_destruir(ContextoOrdenacao *ctx);
+
+#endif // LIBORDENA_H
@@ -0,0 +1,56 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include "utils.h"
+
+#define TAM_BLOCO_MAXIMO_PLANO (1024 * 1024) // Maior bloco de E/S escolhido pelo plano, em bytes
+#define BLOCOS_POR_ORCAMENTO 64              // O bloco escolhido ocupa no máximo 1/64 do orçamento
+#define MIN_MEMORIA_PLANO 3                  // Menor área de trabalho de um método, em itens
+#define FOLGA_RESERVAS_PLANO (16 * 64)       // Arredondamento das reservas de uma fase à linha de cache e
+                                             // estruturas pequenas (árvore de perdedores), em bytes
+
+// Orçamento de memória em bytes (--mem). Sem orçamento (0), cada método usa seus limites fixos.
+void definir_orcamento_memoria(long bytes);
+long orcamento_memoria(void);
+
+// Interpreta um tamanho em bytes com sufixo opcional K, M ou G (potências de 1024); retorna 0 se inválido
+long ler_tamanho_memoria(const char *texto);
+
+// Plano de memória de um método
+typedef struct {
+    int memoria; // Itens na área de trabalho interna (registros, etiquetas...)
+    int fan_in;  // Limite de vias por passada: fitas intercaladas ou baldes (0 se o método não tem vias)
+    int bloco;   // Bytes por bloco de E/S das fitas
+    long bytes;  // Maior soma de memória reservada ao mesmo tempo pelo plano, em bytes
+} PlanoMemoria;
+
+// Requisitos de memória de um método. As fitas custam bytes_fita: a estrutura e o buffer de um bloco.
+typedef struct {
+    int padrao;           // Itens em memória sem orçamento (o limite fixo do método)
+    long bytes_por_item;  // Bytes ocupados por item da área de trabalho
+    long bytes_fixos;     // Estruturas de tamanho fixo (histogramas, área de pivôs...)
+    int buffers_fixos;    // Fitas abertas além das fitas das vias (entrada, saída...), em todas as fases
+    int buffers_geracao;  // Fitas por via abertas junto com a área de trabalho (corridas ou baldes gravados)
+    int buffers_por_fita; // Fitas por via na intercalação, que só começa depois de devolvida a área de
+                          // trabalho (2F: uma de entrada e uma de saída = 2); 0 se o método não intercala
+    long bytes_por_via;   // Estado de cada via além das fitas (registro corrente, folha da árvore...)
+    int max_fan_in;       // Maior número de vias que o método admite (0 se não tem vias)
+} RequisitosMemoria;
+
+// Monta o plano do método para 'quantidade' registros e o registra nas métricas.
+// Sem orçamento, reproduz os limites fixos: 'padrao' itens, fan-in limitado a 'max_fan_in' e a
+// FAN_IN_MAXIMO (na intercalação, também a 'padrao': um item por fita), e o bloco de --bloco
+// ou o padrão. Com orçamento:
+//  - bloco: orçamento / BLOCOS_POR_ORCAMENTO, entre um registro e TAM_BLOCO_MAXIMO_PLANO
+//    (a menos que --bloco tenha sido dado), aplicado às fitas abertas a partir daí;
+//  - fan-in: na intercalação, quantas vias cabem no orçamento com suas fitas e seu estado; as
+//    vias abertas junto com a área de trabalho (corridas gravadas, baldes da distribuição)
+//    ficam com até metade do orçamento;
+//  - memória: o que sobra do orçamento depois das estruturas fixas e das fitas (e do estado das
+//    vias) abertas junto com a área de trabalho, dividido pelo tamanho do item; nunca mais que
+//    'quantidade'.
+// 'bytes' é a maior das duas fases (área de trabalho e intercalação), com FOLGA_RESERVAS_PLANO;
+// a arena corrente é dimensionada com ele.
+void planejar_memoria(const RequisitosMemoria *req, long quantidade, PlanoMemoria *plano, Metricas *stats);
+
+#endif // MEMORIA_H
@@ -0,0 +1,15 @@
+#ifndef METODOS_H
+#define METODOS_H
+
+#include "utils.h"
+
+#define NUM_METODOS 6 // Métodos numerados de 1 a NUM_METODOS na linha de comando
+
+// Arquivo ordenado gravado pelo método (NULL se o método não existe)
+const char *arquivo_saida_metodo(int metodo);
+
+// Ordena os 'quantidade' primeiros registros de 'arquivo' com o método indicado, acumulando
+// as métricas em 'stats'. Retorna 0 se o método não existe.
+int executar_metodo(int metodo, const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
+
+#endif // METODOS_H
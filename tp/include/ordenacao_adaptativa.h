@@ -0,0 +1,43 @@
+#ifndef ORDENACAO_ADAPTATIVA_H
+#define ORDENACAO_ADAPTATIVA_H
+
+#include "utils.h"
+
+// Classificação da entrada pela pré-análise
+#define ENTRADA_ALEATORIA 0       // Sem ordem aproveitável: segue o método escolhido
+#define ENTRADA_ORDENADA 1        // Já está na ordem pedida
+#define ENTRADA_INVERSA 2         // Está na ordem contrária à pedida
+#define ENTRADA_QUASE_ORDENADA 3  // Poucas corridas naturais longas: intercalação natural
+
+// Uma corrida natural só compensa se for, em média, mais longa que as corridas
+// que a seleção por substituição geraria (~2M registros)
+#define FATOR_CORRIDAS_NATURAIS 2
+
+typedef struct {
+    long lidos;             // Registros examinados (menos que a entrada se a análise parou cedo)
+    long corridas;          // Corridas naturais na ordem pedida
+    long corridas_inversas; // Corridas naturais na ordem contrária
+    long fora_de_lugar;     // Registros que vêm depois de um registro maior (na ordem pedida)
+    int classe;             // ENTRADA_*
+} AnaliseEntrada;
+
+// Ativa ou desativa a pré-análise (ativa por padrão)
+void definir_pre_analise(int ativa);
+
+// Pré-análise em uma passada sequencial: mede as corridas naturais e a desordem da entrada.
+// Enquanto a entrada está em ordem, os registros já são copiados para 'destino', de modo que
+// uma entrada ordenada termina nessa mesma passada. A análise para assim que a entrada se
+// mostra aleatória para a memória 'tam_memoria' (em registros) do método; se 'usa_naturais'
+// é 0, só interessam as entradas ordenadas ou inversas e a análise para na primeira quebra de ambas.
+void analisar_entrada(const char *arquivo, const char *destino, int quantidade, int tam_memoria,
+                      int usa_naturais, int ordem, AnaliseEntrada *analise, Metricas *stats);
+
+// Ordena a entrada pelo caminho rápido correspondente à sua classe (cópia, inversão em blocos
+// ou intercalação natural), gravando 'destino'. Retorna 0 se a entrada é aleatória ou a
+// pré-análise está desativada, caso em que o método deve seguir normalmente.
+// Métodos cuja geração de corridas já aproveita a ordem existente (seleção por substituição,
+// que nunca gera mais corridas que as naturais) passam usa_naturais = 0.
+int ordenar_adaptativo(const char *arquivo, const char *destino, int quantidade, int tam_memoria,
+                       int usa_naturais, int ordem, Metricas *stats);
+
+#endif // ORDENACAO_ADAPTATIVA_H
@@ -0,0 +1,23 @@
+#ifndef ORDENACAO_AMOSTRAGEM_H
+#define ORDENACAO_AMOSTRAGEM_H
+
+#include "registro.h"
+#include "utils.h"
+
+#define ARQUIVO_SAIDA_AMOSTRAGEM "./data/saida_amostragem.bin" // Arquivo ordenado produzido pelo método
+
+#define NUM_BALDES 64 // Máximo de intervalos por nível de distribuição (potência de 2; 63 separadores)
+
+// Ordenação por amostragem (samplesort externo): sorteia uma amostra das notas, escolhe até
+// NUM_BALDES - 1 separadores e distribui a entrada em uma única passada entre os baldes
+// (um arquivo por intervalo entre separadores e, quando há notas frequentes, um por separador
+// para as notas iguais a ele).
+// Baldes que cabem na memória são ordenados internamente e anexados à saída; só os maiores
+// são distribuídos de novo. Cada nível divide os dados por até NUM_BALDES, em vez de 2.
+// Ordenação completa por amostragem dos 'quantidade' primeiros registros, gravando 'destino'
+// (sem pré-análise). A primeira distribuição, única passada sobre a entrada, conta como pré-processamento.
+void ordenar_amostragem(const char *arquivo, const char *destino, int quantidade, Metricas *stats, int ordem);
+
+void ordenacao_por_amostragem(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
+
+#endif // ORDENACAO_AMOSTRAGEM_H
@@ -0,0 +1,20 @@
+#ifndef ORDENACAO_CONTAGEM_H
+#define ORDENACAO_CONTAGEM_H
+
+#include "registro.h"
+#include "utils.h"
+
+#define ARQUIVO_SAIDA_CONTAGEM "./data/saida_contagem.bin" // Arquivo ordenado produzido pelo método
+
+#define MAX_VALORES_NOTA 100001  // Maior domínio de notas distintas tratado por contagem
+#define MAX_ESCALA_NOTA 1000     // Precisão máxima tratada: três casas decimais
+
+// Ordenação por contagem sobre o domínio limitado das notas. Uma passada sequencial conta as
+// ocorrências de cada valor, descobrindo ao mesmo tempo a precisão das notas e a faixa exata,
+// e outra espalha os registros direto na posição final de saída, sem nenhuma comparação de
+// chaves. O resultado é estável. Se alguma nota tem mais de três casas decimais ou a faixa
+// passa de MAX_VALORES_NOTA valores, a ordenação recai na ordenação por amostragem, baseada
+// em comparações.
+void ordenacao_por_contagem(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
+
+#endif // ORDENACAO_CONTAGEM_H
@@ -0,0 +1,14 @@
+#ifndef ORDENACAO_ETIQUETAS_H
+#define ORDENACAO_ETIQUETAS_H
+
+#include "registro.h"
+#include "utils.h"
+
+#define ARQUIVO_SAIDA_ETIQUETAS "./data/saida_etiquetas.bin" // Arquivo ordenado produzido pelo método
+
+// Ordenação por etiquetas (tag sort): em vez dos registros de 104 bytes, ordena externamente
+// etiquetas (nota, posição) de 16 bytes com intercalação balanceada em 2F fitas e, ao final,
+// monta o arquivo ordenado buscando os registros em lotes lidos em ordem de posição.
+void ordenacao_por_etiquetas(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime);
+
+#endif // ORDENACAO_ETIQUETAS_H
@@ -0,0 +1,50 @@
+#ifndef ORDENACAO_INTERNA_H
+#define ORDENACAO_INTERNA_H
+
+#include <stdint.h>
+#include "registro.h"
+
+// Par (chave, índice) ordenado no lugar dos registros completos: trocar 8 bytes
+// em vez de 104 e aplicar a permutação sobre os registros uma única vez no final
+typedef struct {
+    float chave;  // Nota já ajustada à ordem pedida (negada na ordem descendente)
+    int indice;   // Posição do registro no vetor original
+} ChaveIndice;
+
+// Par (chave codificada, índice) usado pela ordenação radix
+typedef struct {
+    uint32_t chave; // Nota codificada de forma que a ordem dos inteiros seja a ordem pedida
+    int indice;     // Posição do registro no vetor original
+} ChaveRadix;
+
+// Ordena os pares por (chave, indice) com introsort: quicksort com mediana de três,
+// heapsort quando a recursão degenera e inserção nos intervalos pequenos.
+// O desempate pelo índice torna o resultado estável. Retorna o número de comparações.
+long ordenar_chaves(ChaveIndice *v, int n);
+
+// Reorganiza 'registros' de forma que a posição k receba registros[v[k].indice]
+// (segue os ciclos da permutação, movendo cada registro uma única vez)
+void aplicar_permutacao(Registro *registros, ChaveIndice *v, int n);
+
+// Ordena um vetor de registros pela nota na ordem indicada (ORDEM_ASCENDENTE/ORDEM_DESCENDENTE).
+// Retorna o número de comparações realizadas.
+long ordenar_registros(Registro *registros, int n, int ordem);
+
+// Codifica a nota como uint32 preservando a ordem: inverte todos os bits dos negativos e
+// apenas o bit de sinal dos positivos. Na ordem descendente, o código é complementado.
+uint32_t codificar_nota(float nota, int ordem);
+
+// Ordenação radix LSD estável em 4 passadas de 1 byte (contagem + soma de prefixos + espalhamento).
+// 'aux' deve ter espaço para n pares; o resultado fica em 'v'. Passadas em que todos os
+// pares têm o mesmo byte são puladas.
+void ordenar_chaves_radix(ChaveRadix *v, ChaveRadix *aux, int n);
+
+// Ordena um vetor de registros pela nota em tempo linear (radix sobre as notas codificadas)
+void ordenar_registros_radix(Registro *registros, int n, int ordem);
+
+// Ordena apenas os pares (nota codificada, índice) de registros somente leitura (por exemplo,
+// um arquivo mapeado): ao final, v[k].indice é a posição do k-ésimo registro na ordem pedida.
+// 'v' deve ter espaço para 2 * n pares (a segunda metade é a área auxiliar).
+void ordenar_indices_radix(const Registro *registros, ChaveRadix *v, int n, int ordem);
+
+#endif // ORDENACAO_INTERNA_H
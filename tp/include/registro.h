@@ -13,6 +13,13 @@ typedef struct {
     char curso[TAM_CURSO];
 } Registro;
 
+#define TAM_LINHA_REGISTRO 256 // Espaço suficiente para uma linha formatada por formatar_registro
+
 void print_registro(const Registro *r);
 
+// Formata o registro exatamente como print_registro, sem passar pelo printf (conversão
+// de números feita à mão). Grava no máximo TAM_LINHA_REGISTRO bytes, sem o terminador nulo,
+// e retorna o tamanho da linha.
+int formatar_registro(const Registro *r, char *destino);
+
 #endif // REGISTRO_H
@@ -0,0 +1,16 @@
+#ifndef SELECAO_TOP_H
+#define SELECAO_TOP_H
+
+#include "registro.h"
+#include "utils.h"
+
+#define ARQUIVO_SAIDA_TOP "./data/saida_top.bin" // Os K primeiros registros na ordem pedida
+
+// Seleção dos K primeiros registros na ordem pedida (as K menores notas na ordem ascendente,
+// as K maiores na descendente) sem ordenar a entrada inteira: uma única passada sequencial
+// mantém em um heap de K nós os melhores registros vistos, com o pior deles na raiz.
+// Tempo O(N log K) e memória O(K). A saída é a mesma que os K primeiros registros de uma
+// ordenação estável: entre notas iguais, prevalece o registro que aparece antes na entrada.
+void selecionar_top(const char *arquivo, int quantidade, int k, int situacao, Metricas *stats, int imprime);
+
+#endif // SELECAO_TOP_H
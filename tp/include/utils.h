@@ -3,20 +3,88 @@
 
 #include <time.h>
 
+#define MAX_FASES 32      // Fases registradas por execução (as excedentes não são detalhadas)
+#define TAM_NOME_FASE 32
+
+// Formatos de saída de log_metricas
+#define METRICAS_TEXTO 0 // Texto legível (padrão)
+#define METRICAS_JSON 1  // Um objeto JSON por execução
+#define METRICAS_CSV 2   // Uma linha por fase, mais as etapas pre e pos e o total, com cabeçalho
+
+// Marca de tempo: relógio de parede monotônico e tempo de CPU do processo
+typedef struct {
+    struct timespec parede;
+    clock_t cpu;
+} Cronometro;
+
+// Fase da execução medida à parte (geração das corridas, cada passada de intercalação, saída...).
+// Enquanto a fase está aberta, os contadores guardam o valor negado do início; ao fechar,
+// o valor do fim é somado e sobra a diferença (evita guardar uma cópia dos contadores).
 typedef struct {
-    int leituras_pre;
-    int escritas_pre;
-    int comparacoes_pre;
-    double tempo_execucao_pre;
-
-    int leituras_pos;
-    int escritas_pos;
-    int comparacoes_pos;
+    char nome[TAM_NOME_FASE];
+    Cronometro inicio;
+    double tempo_parede;
+    double tempo_cpu;
+    long leituras;
+    long escritas;
+    long comparacoes;
+    long blocos_lidos;
+    long blocos_escritos;
+    long bytes_lidos;
+    long bytes_escritos;
+} Fase;
+
+typedef struct {
+    long leituras_pre;
+    long escritas_pre;
+    long comparacoes_pre;
+    double tempo_execucao_pre; // Tempo de parede, em segundos
+
+    long leituras_pos;
+    long escritas_pos;
+    long comparacoes_pos;
     double tempo_execucao_pos;
+
+    // Transferências de blocos entre disco e memória (cada uma com vários registros)
+    long blocos_lidos_pre;
+    long blocos_escritos_pre;
+    long blocos_lidos_pos;
+    long blocos_escritos_pos;
+
+    // Plano de memória do método (ver planejar_memoria)
+    long memoria_orcamento; // Bytes (0: limites fixos)
+    int memoria_plano;      // Itens na área de trabalho
+    int fan_in_plano;       // Limite de vias por passada (0: sem vias)
+    int bloco_plano;        // Bytes por bloco
+    long bytes_plano;       // Memória reservada pelo plano na fase mais cara
+
+    // Corridas iniciais geradas (ver registrar_tamanho_corrida)
+    long num_corridas;
+    long registros_corridas; // Soma dos tamanhos
+    long menor_corrida;
+    long maior_corrida;
+
+    int num_fases;   // Fases registradas em 'fases'
+    int fase_aberta; // Índice + 1 da fase em andamento (0: nenhuma)
+    Fase fases[MAX_FASES];
 } Metricas;
 
-void iniciar_tempo(clock_t *inicio);
-void finalizar_tempo(clock_t *inicio, clock_t *fim, double *tempo_execucao);
+void iniciar_tempo(Cronometro *inicio);
+// Tempo de parede decorrido desde 'inicio', em segundos ('fim' recebe a marca final)
+void finalizar_tempo(Cronometro *inicio, Cronometro *fim, double *tempo_execucao);
+
+// Abre e fecha uma fase de 'm'. As fases não se aninham: abrir uma fase fecha a anterior.
+void iniciar_fase(Metricas *m, const char *nome);
+void finalizar_fase(Metricas *m);
+
+// Registra o tamanho de uma corrida inicial gerada pelo método
+void registrar_tamanho_corrida(Metricas *m, long tamanho);
+
+// Bytes transferidos entre o processo e os arquivos (contados pelas rotinas de E/S)
+void registrar_bytes(long lidos, long escritos);
+void consultar_bytes(long *lidos, long *escritos);
+
+void definir_formato_metricas(int formato);
 void log_metricas(const char *metodo, int quantidade, const char *situacao, Metricas m);
 
 #endif // UTILS_H
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/arena.h"
+
+struct Arena {
+    char *bloco;      // Memória da arena
+    long capacidade;  // Bytes do bloco
+    long limite;      // Bytes que podem ser reservados (o plano de memória)
+    long usado;       // Deslocamento da próxima reserva
+    long reservas[MAX_RESERVAS_ARENA]; // Deslocamento das reservas ainda não devolvidas, em ordem
+    char devolvida[MAX_RESERVAS_ARENA]; // 1 se a reserva foi liberada fora de ordem
+    int num_reservas;
+    long pico;
+    long fora;        // Reservas atendidas pelo malloc com a arena ativa
+    int ativa;
+};
+
+static Arena arena_ordenacao;               // Mantida entre ordenações
+static Arena *corrente = &arena_ordenacao;
+
+// Esvazia a arena
+static void esvaziar(Arena *a) {
+    a->usado = 0;
+    a->num_reservas = 0;
+    a->pico = 0;
+    a->fora = 0;
+}
+
+// Troca o bloco (vazio) por um de 'bytes' bytes; sem memória, as reservas vão todas para o malloc
+static void trocar_bloco(Arena *a, long bytes) {
+    free(a->bloco);
+    a->bloco = NULL;
+    a->capacidade = 0;
+    void *novo;
+    if (posix_memalign(&novo, ALINHAMENTO_ARENA, bytes) == 0) {
+        a->bloco = (char *)novo;
+        a->capacidade = bytes;
+    }
+}
+
+void ativar_arena(void) {
+    esvaziar(&arena_ordenacao);
+    arena_ordenacao.limite = 0;
+    arena_ordenacao.ativa = 1;
+}
+
+void dimensionar_arena(long bytes) {
+    Arena *a = corrente;
+    if (!a->ativa) return;
+    bytes = (bytes + ALINHAMENTO_ARENA - 1) / ALINHAMENTO_ARENA * ALINHAMENTO_ARENA;
+    if (bytes > a->capacidade && a->usado == 0) trocar_bloco(a, bytes);
+    a->limite = (bytes < a->capacidade) ? bytes : a->capacidade;
+    if (a->limite < a->usado) a->limite = a->usado;
+}
+
+void desativar_arena(void) {
+    esvaziar(&arena_ordenacao);
+    arena_ordenacao.limite = 0;
+    arena_ordenacao.ativa = 0;
+}
+
+void liberar_arena(void) {
+    if (arena_ordenacao.ativa) return;
+    free(arena_ordenacao.bloco);
+    arena_ordenacao.bloco = NULL;
+    arena_ordenacao.capacidade = 0;
+}
+
+Arena *criar_arena(long bytes) {
+    Arena *a = (Arena *)calloc(1, sizeof(Arena));
+    if (!a) return NULL;
+    trocar_bloco(a, bytes > 0 ? bytes : ALINHAMENTO_ARENA);
+    if (!a->bloco) {
+        free(a);
+        return NULL;
+    }
+    a->limite = a->capacidade;
+    a->ativa = 1;
+    return a;
+}
+
+void destruir_arena(Arena *arena) {
+    if (!arena) return;
+    if (corrente == arena) corrente = &arena_ordenacao;
+    free(arena->bloco);
+    free(arena);
+}
+
+Arena *usar_arena(Arena *arena) {
+    Arena *anterior = (corrente == &arena_ordenacao) ? NULL : corrente;
+    corrente = arena ? arena : &arena_ordenacao;
+    return anterior;
+}
+
+static int dentro_da_arena(const Arena *a, const void *p) {
+    return a->bloco && (const char *)p >= a->bloco && (const char *)p < a->bloco + a->capacidade;
+}
+
+void *alocar_temporario(size_t bytes) {
+    Arena *a = corrente;
+    if (bytes == 0) bytes = 1;
+    long tamanho = ((long)bytes + ALINHAMENTO_ARENA - 1) / ALINHAMENTO_ARENA * ALINHAMENTO_ARENA;
+    if (a->ativa && a->limite - a->usado >= tamanho) {
+        // Com a pilha cheia, as reservas anteriores só voltam na restauração da marca
+        if (a->num_reservas == MAX_RESERVAS_ARENA) a->num_reservas = 0;
+        a->reservas[a->num_reservas] = a->usado;
+        a->devolvida[a->num_reservas++] = 0;
+        a->usado += tamanho;
+        if (a->usado > a->pico) a->pico = a->usado;
+        return a->bloco + a->reservas[a->num_reservas - 1];
+    }
+
+    void *p;
+    if (posix_memalign(&p, ALINHAMENTO_ARENA, bytes) != 0) return NULL;
+    if (a->ativa) a->fora++;
+    return p;
+}
+
+void liberar_temporario(void *p) {
+    Arena *a = corrente;
+    if (!p) return;
+    if (!dentro_da_arena(a, p)) {
+        free(p);
+        return;
+    }
+    if (!a->ativa) return;
+    long deslocamento = (const char *)p - a->bloco;
+    int i = a->num_reservas - 1;
+    while (i >= 0 && a->reservas[i] != deslocamento) i--;
+    if (i < 0) return; // Já devolvida pela restauração de uma marca
+    a->devolvida[i] = 1;
+    // O topo volta na hora, com as reservas abaixo dele liberadas antes (fora de ordem)
+    while (a->num_reservas > 0 && a->devolvida[a->num_reservas - 1]) {
+        a->usado = a->reservas[--a->num_reservas];
+    }
+}
+
+long marcar_arena(void) {
+    return corrente->usado;
+}
+
+void restaurar_arena(long marca) {
+    Arena *a = corrente;
+    if (marca < a->usado) {
+        a->usado = marca;
+        while (a->num_reservas > 0 && a->reservas[a->num_reservas - 1] >= marca) a->num_reservas--;
+    }
+}
+
+void consultar_arena(long *pico_arena, long *tamanho, long *fora_arena) {
+    *pico_arena = corrente->pico;
+    *tamanho = corrente->ativa ? corrente->limite : 0;
+    *fora_arena = corrente->fora;
+}
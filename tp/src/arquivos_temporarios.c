@@ -0,0 +1,217 @@
+#define _GNU_SOURCE // O_TMPFILE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/arquivos_temporarios.h"
+#include "../include/leitura.h"
+
+typedef struct {
+    int fd;     // -1 depois de exportado: um arquivo novo é criado na próxima reserva
+    int livre;  // 1 se pode ser entregue pela próxima reserva
+    long bytes; // Tamanho na última contabilização
+    pid_t dono; // Processo que criou o descritor (um filho do benchmark herda a tabela do pai)
+    char *diretorio; // Onde o arquivo foi criado: só é reaproveitado por reservas no mesmo diretório
+} ArquivoTemporario;
+
+static const char *diretorio = DIRETORIO_TEMPORARIO_PADRAO;
+static const char *destino_pedido = NULL; // --saida
+static ArquivoTemporario *arquivos = NULL;
+static int num_arquivos = 0;
+static int capacidade = 0;
+static long criados = 0;
+static long bytes_em_uso = 0;
+static long pico_bytes = 0;
+
+void definir_diretorio_temporario(const char *dir) {
+    diretorio = dir;
+}
+
+const char *diretorio_temporario(void) {
+    return diretorio;
+}
+
+// Cria um arquivo sem nome em 'dir'; retorna o descritor ou -1
+static int criar_arquivo_anonimo(const char *dir) {
+    int fd;
+#ifdef O_TMPFILE
+    fd = open(dir, O_TMPFILE | O_RDWR, 0644);
+    if (fd >= 0) return fd;
+    // Sistemas de arquivos sem suporte recusam com EOPNOTSUPP/EISDIR: usa o nome provisório
+#endif
+    char nome[4096];
+    snprintf(nome, sizeof(nome), "%s/ordena_XXXXXX", dir);
+    fd = mkstemp(nome);
+    if (fd >= 0) unlink(nome);
+    return fd;
+}
+
+// Cria o arquivo da posição i em 'dir'; retorna 0 se não foi possível
+static int criar_arquivo(int i, const char *dir) {
+    int fd = criar_arquivo_anonimo(dir);
+    if (fd < 0) return 0;
+    char *copia = strdup(dir);
+    if (!copia) {
+        close(fd);
+        return 0;
+    }
+    if (arquivos[i].fd >= 0) close(arquivos[i].fd);
+    free(arquivos[i].diretorio);
+    arquivos[i].fd = fd;
+    arquivos[i].diretorio = copia;
+    arquivos[i].bytes = 0;
+    arquivos[i].dono = getpid();
+    criados++;
+    return 1;
+}
+
+int tentar_reservar_arquivo_temporario(const char *dir) {
+    if (!dir) dir = diretorio;
+    // Um arquivo livre de outro diretório só é aproveitado se não houver um do mesmo
+    int livre = -1;
+    for (int i = 0; i < num_arquivos; i++) {
+        if (!arquivos[i].livre) continue;
+        if (arquivos[i].fd >= 0 && strcmp(arquivos[i].diretorio, dir) == 0) {
+            arquivos[i].livre = 0;
+            return i;
+        }
+        if (livre < 0) livre = i;
+    }
+
+    if (livre < 0) {
+        if (num_arquivos == capacidade) {
+            int nova = capacidade ? 2 * capacidade : 64;
+            ArquivoTemporario *v = (ArquivoTemporario *)realloc(arquivos, nova * sizeof(ArquivoTemporario));
+            if (!v) return -1;
+            arquivos = v;
+            capacidade = nova;
+        }
+        livre = num_arquivos;
+        arquivos[livre].fd = -1;
+        arquivos[livre].diretorio = NULL;
+        arquivos[livre].livre = 1;
+        num_arquivos++;
+    }
+    if (!criar_arquivo(livre, dir)) return -1;
+    arquivos[livre].livre = 0;
+    return livre;
+}
+
+int reservar_arquivo_temporario(void) {
+    int id = tentar_reservar_arquivo_temporario(NULL);
+    if (id < 0) {
+        perror("Erro ao criar arquivo temporário");
+        exit(EXIT_FAILURE);
+    }
+    return id;
+}
+
+void devolver_arquivo_temporario(int id) {
+    if (ftruncate(arquivos[id].fd, 0) != 0) {
+        perror("Erro ao truncar arquivo temporário");
+        exit(EXIT_FAILURE);
+    }
+    bytes_em_uso -= arquivos[id].bytes;
+    arquivos[id].bytes = 0;
+    arquivos[id].livre = 1;
+}
+
+int descritor_arquivo_temporario(int id) {
+    return arquivos[id].fd;
+}
+
+void caminho_arquivo_temporario(int id, char *caminho, size_t tamanho) {
+    snprintf(caminho, tamanho, "/proc/self/fd/%d", arquivos[id].fd);
+}
+
+// Arquivo reservado cujo caminho (caminho_arquivo_temporario) é 'nome', ou -1
+static int temporario_do_caminho(const char *nome) {
+    int fd;
+    char resto;
+    if (sscanf(nome, "/proc/self/fd/%d%c", &fd, &resto) != 1) return -1;
+    for (int i = 0; i < num_arquivos; i++) {
+        if (arquivos[i].fd == fd && !arquivos[i].livre) return i;
+    }
+    return -1;
+}
+
+void registrar_uso_arquivo_temporario(int id) {
+    struct stat st;
+    if (fstat(arquivos[id].fd, &st) != 0) return;
+    bytes_em_uso += (long)st.st_size - arquivos[id].bytes;
+    arquivos[id].bytes = (long)st.st_size;
+    if (bytes_em_uso > pico_bytes) pico_bytes = bytes_em_uso;
+}
+
+void exportar_arquivo_temporario(int id, const char *destino) {
+    // O destino é outro temporário (a saída preparada de um método): o descritor dele passa a
+    // ser o deste arquivo, sem cópia, e o caminho do destino continua valendo. Um temporário
+    // herdado do processo pai só pode receber uma cópia, que o pai enxerga.
+    int alvo = temporario_do_caminho(destino);
+    if (alvo >= 0 && alvo != id && arquivos[alvo].dono == getpid()) {
+        if (dup2(arquivos[id].fd, arquivos[alvo].fd) < 0) {
+            perror("Erro ao exportar arquivo temporário");
+            exit(EXIT_FAILURE);
+        }
+        close(arquivos[id].fd);
+        arquivos[id].fd = -1;
+        arquivos[id].livre = 1;
+        bytes_em_uso -= arquivos[alvo].bytes;
+        arquivos[alvo].bytes = arquivos[id].bytes;
+        arquivos[id].bytes = 0;
+        return;
+    }
+
+    // Um arquivo de O_TMPFILE ganha um nome pelo link de /proc; o de mkstemp (já sem nome) e o
+    // de outro sistema de arquivos são copiados
+    if (alvo < 0) {
+        char caminho[TAM_CAMINHO_TEMPORARIO];
+        caminho_arquivo_temporario(id, caminho, sizeof(caminho));
+        unlink(destino);
+        if (linkat(AT_FDCWD, caminho, AT_FDCWD, destino, AT_SYMLINK_FOLLOW) == 0) {
+            // O arquivo agora pertence ao destino: não é truncado nem reaproveitado
+            close(arquivos[id].fd);
+            arquivos[id].fd = -1;
+            bytes_em_uso -= arquivos[id].bytes;
+            arquivos[id].bytes = 0;
+            arquivos[id].livre = 1;
+            return;
+        }
+    }
+    copiar_binario_descritor(arquivos[id].fd, destino);
+    devolver_arquivo_temporario(id);
+}
+
+void definir_destino_saida(const char *destino) {
+    destino_pedido = destino;
+}
+
+const char *destino_saida(const char *padrao) {
+    return destino_pedido ? destino_pedido : padrao;
+}
+
+int preparar_saida(char *caminho) {
+    int arquivo = reservar_arquivo_temporario();
+    caminho_arquivo_temporario(arquivo, caminho, TAM_CAMINHO_TEMPORARIO);
+    return arquivo;
+}
+
+const char *concluir_saida(int arquivo, const char *padrao) {
+    const char *destino = destino_saida(padrao);
+    exportar_arquivo_temporario(arquivo, destino);
+    return destino;
+}
+
+void reiniciar_uso_temporarios(void) {
+    criados = 0;
+    pico_bytes = bytes_em_uso;
+}
+
+void consultar_arquivos_temporarios(long *arquivos_criados, long *bytes, long *pico) {
+    *arquivos_criados = criados;
+    *bytes = bytes_em_uso;
+    *pico = pico_bytes;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/arvore_perdedores.h"
+#include "../include/intercalacao2f.h"
+#include "../include/arena.h"
+
+// Retorna 1 se a fonte 'x' vence a fonte 'y'.
+// O índice -1 é a sentinela usada na construção e vence qualquer fonte;
+// fontes inativas perdem para as ativas; empates (nas chaves ou pelo comparador) são decididos
+// pela menor chave secundária, se houver, e depois pelo menor índice (estável).
+static int vence(ArvorePerdedores *arv, int x, int y) {
+    if (x < 0) return 1;
+    if (y < 0) return 0;
+    if (!arv->ativa[x]) return !arv->ativa[y] && x < y;
+    if (!arv->ativa[y]) return 1;
+
+    if (arv->comparacoes) (*arv->comparacoes)++;
+    if (arv->comparar) {
+        int c = arv->comparar(x, y, arv->dados);
+        if (c != 0) return c < 0;
+    } else {
+        float cx = arv->chaves[x];
+        float cy = arv->chaves[y];
+        if (cx != cy) return (arv->ordem == ORDEM_ASCENDENTE) ? cx < cy : cx > cy;
+    }
+    if (arv->desempate && arv->desempate[x] != arv->desempate[y]) {
+        return arv->desempate[x] < arv->desempate[y];
+    }
+    return x < y;
+}
+
+// Sobe da folha 'fonte' até a raiz, deixando em cada nó o perdedor da disputa
+static void refazer_caminho(ArvorePerdedores *arv, int fonte) {
+    int vencedor = fonte;
+    for (int no = (fonte + arv->k) / 2; no > 0; no /= 2) {
+        if (vence(arv, arv->arvore[no], vencedor)) {
+            int perdedor = vencedor;
+            vencedor = arv->arvore[no];
+            arv->arvore[no] = perdedor;
+        }
+    }
+    arv->arvore[0] = vencedor;
+}
+
+// A árvore e seus três vetores ocupam uma única reserva temporária
+ArvorePerdedores *criar_arvore_perdedores(int k, int ordem, long *comparacoes) {
+    int n = (k > 0) ? k : 1;
+    size_t bytes = sizeof(ArvorePerdedores) + n * BYTES_FOLHA_ARVORE;
+    ArvorePerdedores *arv = (ArvorePerdedores *)alocar_temporario(bytes);
+    if (!arv) return NULL;
+    memset(arv, 0, bytes);
+
+    arv->k = k;
+    arv->ordem = ordem;
+    arv->comparacoes = comparacoes;
+    arv->desempate = NULL;
+    arv->comparar = NULL;
+    arv->dados = NULL;
+    arv->arvore = (int *)(arv + 1);
+    arv->ativa = arv->arvore + n;
+    arv->chaves = (float *)(arv->ativa + n);
+    return arv;
+}
+
+void liberar_arvore_perdedores(ArvorePerdedores *arv) {
+    liberar_temporario(arv);
+}
+
+void construir_arvore_perdedores(ArvorePerdedores *arv) {
+    // Todos os nós começam com a sentinela, que é empurrada para fora à medida que as folhas sobem
+    for (int i = 0; i < arv->k; i++) {
+        arv->arvore[i] = -1;
+    }
+    for (int fonte = arv->k - 1; fonte >= 0; fonte--) {
+        refazer_caminho(arv, fonte);
+    }
+}
+
+int vencedora_arvore_perdedores(const ArvorePerdedores *arv) {
+    if (arv->k <= 0) return -1;
+    int vencedora = arv->arvore[0];
+    return arv->ativa[vencedora] ? vencedora : -1;
+}
+
+void atualizar_arvore_perdedores(ArvorePerdedores *arv, int fonte, float chave, int ativa) {
+    arv->chaves[fonte] = chave;
+    arv->ativa[fonte] = ativa;
+    refazer_caminho(arv, fonte);
+}
+
+int calcular_fan_in(int tam_memoria, long num_corridas) {
+    long fan_in = num_corridas;
+    if (fan_in > tam_memoria) fan_in = tam_memoria;
+    if (fan_in > FAN_IN_MAXIMO) fan_in = FAN_IN_MAXIMO;
+    if (fan_in < 2) fan_in = 2;
+    return (int)fan_in;
+}
@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../include/benchmark.h"
+#include "../include/metodos.h"
+#include "../include/ordenacao_amostragem.h"
+#include "../include/intercalacao2f.h"
+#include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+#include "../include/utils.h"
+
+#define ENTRADA_ALEATORIA_BENCH 0 // Arquivo de registros como está
+#define ENTRADA_ORDENADA_BENCH 1  // Ordenado de forma ascendente
+#define ENTRADA_INVERSA_BENCH 2   // Ordenado de forma descendente
+
+static const char *nomes_entrada[] = {"aleatoria", "ordenada", "inversa"};
+
+// Parâmetros do benchmark
+typedef struct {
+    const char *arquivo;
+    const char *saida_csv;
+    int metodos[MAX_VALORES_BENCH];
+    int num_metodos;
+    int quantidades[MAX_VALORES_BENCH];
+    int num_quantidades;
+    int situacoes[MAX_VALORES_BENCH];
+    int num_situacoes;
+    int entradas[MAX_VALORES_BENCH];
+    int num_entradas;
+    int blocos[MAX_VALORES_BENCH];      // 0: bloco padrão ou derivado do orçamento
+    int num_blocos;
+    long memorias[MAX_VALORES_BENCH];   // Orçamentos de memória (0: limites fixos dos métodos)
+    int num_memorias;
+    int repeticoes;
+    int aquecimento;
+    int cache_frio;
+} ConfigBench;
+
+// Resultado de uma execução, enviado pelo processo filho
+typedef struct {
+    Metricas stats;
+    double tempo_parede;
+    double tempo_cpu;
+    long bytes_lidos;
+    long bytes_escritos;
+} ResultadoExecucao;
+
+// Lê uma lista de inteiros separados por vírgula; retorna quantos foram lidos (0 se inválida)
+static int ler_lista(const char *texto, int *valores) {
+    int n = 0;
+    const char *p = texto;
+    while (*p && n < MAX_VALORES_BENCH) {
+        char *fim;
+        long v = strtol(p, &fim, 10);
+        if (fim == p || v <= 0) return 0;
+        valores[n++] = (int)v;
+        p = (*fim == ',') ? fim + 1 : fim;
+        if (*fim != ',' && *fim != '\0') return 0;
+    }
+    return n;
+}
+
+// Lê uma lista de tamanhos de memória (com sufixos K, M e G) separados por vírgula
+static int ler_memorias(const char *texto, long *valores) {
+    char copia[256];
+    snprintf(copia, sizeof(copia), "%s", texto);
+    int n = 0;
+    for (char *item = strtok(copia, ","); item && n < MAX_VALORES_BENCH; item = strtok(NULL, ",")) {
+        long bytes = ler_tamanho_memoria(item);
+        if (bytes < (long)sizeof(Registro)) return 0;
+        valores[n++] = bytes;
+    }
+    return n;
+}
+
+// Lê a lista de ordens da entrada (aleatoria,ordenada,inversa)
+static int ler_entradas(const char *texto, int *valores) {
+    char copia[256];
+    snprintf(copia, sizeof(copia), "%s", texto);
+    int n = 0;
+    for (char *nome = strtok(copia, ","); nome && n < MAX_VALORES_BENCH; nome = strtok(NULL, ",")) {
+        int achou = -1;
+        for (int e = 0; e < 3; e++) {
+            if (strcmp(nome, nomes_entrada[e]) == 0) achou = e;
+        }
+        if (achou < 0) return 0;
+        valores[n++] = achou;
+    }
+    return n;
+}
+
+static int ler_config(int argc, char *argv[], ConfigBench *cfg) {
+    memset(cfg, 0, sizeof(ConfigBench));
+    cfg->arquivo = ARQUIVO_REGISTROS;
+    cfg->repeticoes = REPETICOES_PADRAO;
+    cfg->aquecimento = AQUECIMENTO_PADRAO;
+    cfg->cache_frio = 1;
+    for (int m = 1; m <= NUM_METODOS; m++) cfg->metodos[cfg->num_metodos++] = m;
+    cfg->quantidades[0] = 1000;
+    cfg->quantidades[1] = 10000;
+    cfg->quantidades[2] = 100000;
+    cfg->num_quantidades = 3;
+    cfg->situacoes[cfg->num_situacoes++] = 1;
+    cfg->entradas[cfg->num_entradas++] = ENTRADA_ALEATORIA_BENCH;
+    cfg->blocos[cfg->num_blocos++] = 0;
+    cfg->memorias[cfg->num_memorias++] = 0;
+
+    for (int i = 2; i < argc; i++) {
+        int tem_valor = i + 1 < argc;
+        if (strcmp(argv[i], "--metodos") == 0 && tem_valor) {
+            cfg->num_metodos = ler_lista(argv[++i], cfg->metodos);
+            for (int k = 0; k < cfg->num_metodos; k++) {
+                if (cfg->metodos[k] > NUM_METODOS) cfg->num_metodos = 0;
+            }
+            if (cfg->num_metodos == 0) {
+                printf("Lista de métodos inválida (use números de 1 a %d).\n", NUM_METODOS);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--quantidades") == 0 && tem_valor) {
+            if ((cfg->num_quantidades = ler_lista(argv[++i], cfg->quantidades)) == 0) {
+                printf("Lista de quantidades inválida.\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--situacoes") == 0 && tem_valor) {
+            cfg->num_situacoes = ler_lista(argv[++i], cfg->situacoes);
+            for (int k = 0; k < cfg->num_situacoes; k++) {
+                if (cfg->situacoes[k] > 3) cfg->num_situacoes = 0;
+            }
+            if (cfg->num_situacoes == 0) {
+                printf("Lista de situações inválida (use 1, 2 ou 3).\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--entradas") == 0 && tem_valor) {
+            if ((cfg->num_entradas = ler_entradas(argv[++i], cfg->entradas)) == 0) {
+                printf("Lista de entradas inválida (use aleatoria, ordenada ou inversa).\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--blocos") == 0 && tem_valor) {
+            cfg->num_blocos = ler_lista(argv[++i], cfg->blocos);
+            for (int k = 0; k < cfg->num_blocos; k++) {
+                if (cfg->blocos[k] < (int)sizeof(Registro)) cfg->num_blocos = 0;
+            }
+            if (cfg->num_blocos == 0) {
+                printf("Lista de blocos inválida: use ao menos %d bytes.\n", (int)sizeof(Registro));
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--memorias") == 0 && tem_valor) {
+            if ((cfg->num_memorias = ler_memorias(argv[++i], cfg->memorias)) == 0) {
+                printf("Lista de memórias inválida: use ao menos %d bytes (aceita sufixos K, M e G).\n",
+                       (int)sizeof(Registro));
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--repeticoes") == 0 && tem_valor) {
+            cfg->repeticoes = atoi(argv[++i]);
+            if (cfg->repeticoes < 1 || cfg->repeticoes > MAX_REPETICOES_BENCH) {
+                printf("Número de repetições inválido (1 a %d).\n", MAX_REPETICOES_BENCH);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--aquecimento") == 0 && tem_valor) {
+            cfg->aquecimento = atoi(argv[++i]);
+            if (cfg->aquecimento < 0) cfg->aquecimento = 0;
+        } else if (strcmp(argv[i], "--arquivo") == 0 && tem_valor) {
+            cfg->arquivo = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && tem_valor) {
+            cfg->saida_csv = argv[++i];
+        } else if (strcmp(argv[i], "--tmp") == 0 && tem_valor) {
+            definir_diretorio_temporario(argv[++i]); // Herdado pelos processos de cada medição
+        } else if (strcmp(argv[i], "--cache-quente") == 0) {
+            cfg->cache_frio = 0;
+        } else {
+            printf("Argumento desconhecido: %s\n", argv[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Descarta do cache de páginas os dados já gravados. Com permissão, esvazia o cache inteiro;
+// sem ela, ao menos pede ao núcleo que descarte as páginas da entrada.
+// Retorna 1 se o cache inteiro foi descartado.
+static int descartar_cache(const char *arquivo) {
+    sync();
+    int fd = open("/proc/sys/vm/drop_caches", O_WRONLY);
+    if (fd >= 0) {
+        int ok = write(fd, "1", 1) == 1;
+        close(fd);
+        if (ok) return 1;
+    }
+    fd = open(arquivo, O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+    return 0;
+}
+
+// Lê exatamente 'bytes' bytes do pipe; retorna 0 se ele fechou antes
+static int ler_pipe(int fd, void *destino, long bytes) {
+    long feito = 0;
+    while (feito < bytes) {
+        ssize_t r = read(fd, (char *)destino + feito, bytes - feito);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return 0;
+        feito += r;
+    }
+    return 1;
+}
+
+// Executa um método em um processo filho, com a saída padrão descartada.
+// 'metodo' = 0 prepara uma entrada: ordena o arquivo por amostragem na ordem 'situacao'.
+// 'bloco' e 'memoria' iguais a 0 mantêm o bloco padrão e os limites fixos dos métodos.
+static int executar_isolado(int metodo, const char *arquivo, const char *destino, int quantidade,
+                            int situacao, int bloco, long memoria, ResultadoExecucao *r) {
+    int canal[2];
+    if (pipe(canal) != 0) {
+        perror("Erro ao criar o pipe do benchmark");
+        exit(EXIT_FAILURE);
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Erro ao criar o processo do benchmark");
+        exit(EXIT_FAILURE);
+    }
+
+    if (pid == 0) {
+        close(canal[0]);
+        int nulo = open("/dev/null", O_WRONLY);
+        if (nulo >= 0) dup2(nulo, STDOUT_FILENO);
+
+        ResultadoExecucao res;
+        memset(&res, 0, sizeof(res));
+        Cronometro inicio, fim;
+        if (bloco > 0) definir_tamanho_bloco(bloco);
+        definir_orcamento_memoria(memoria);
+        iniciar_tempo(&inicio);
+        if (metodo == 0) {
+            ativar_arena();
+            ordenar_amostragem(arquivo, destino, quantidade, &res.stats, situacao);
+            desativar_arena();
+        } else {
+            // A saída vai para um temporário do filho, descartado quando ele termina
+            char descarte[TAM_CAMINHO_TEMPORARIO];
+            caminho_arquivo_temporario(reservar_arquivo_temporario(), descarte, sizeof(descarte));
+            definir_destino_saida(descarte);
+            executar_metodo(metodo, arquivo, quantidade, situacao, &res.stats, 0);
+        }
+        finalizar_tempo(&inicio, &fim, &res.tempo_parede);
+        res.tempo_cpu = (double)clock() / CLOCKS_PER_SEC;
+        consultar_bytes(&res.bytes_lidos, &res.bytes_escritos);
+
+        long feito = 0;
+        while (feito < (long)sizeof(res)) {
+            ssize_t w = write(canal[1], (char *)&res + feito, sizeof(res) - feito);
+            if (w <= 0) _exit(EXIT_FAILURE);
+            feito += w;
+        }
+        _exit(0);
+    }
+
+    close(canal[1]);
+    int recebido = ler_pipe(canal[0], r, sizeof(ResultadoExecucao));
+    close(canal[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return recebido && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int comparar_tempos(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil pela posição mais próxima (tempos já ordenados)
+static double percentil(const double *tempos, int n, int p) {
+    int posicao = (p * n + 99) / 100;
+    if (posicao < 1) posicao = 1;
+    return tempos[posicao - 1];
+}
+
+// Número de passadas de intercalação registradas nas fases
+static int contar_passadas(const Metricas *m) {
+    int passadas = 0;
+    for (int i = 0; i < m->num_fases; i++) {
+        if (strncmp(m->fases[i].nome, "passada", 7) == 0) passadas++;
+    }
+    return passadas;
+}
+
+int executar_benchmark(int argc, char *argv[]) {
+    ConfigBench cfg;
+    if (!ler_config(argc, argv, &cfg)) {
+        printf("Uso: ordena bench [--metodos 1,2,...] [--quantidades N1,N2,...] [--situacoes 1,2,3]\n"
+               "                  [--entradas aleatoria,ordenada,inversa] [--blocos bytes,...]\n"
+               "                  [--memorias bytes[K|M|G],...]\n"
+               "                  [--repeticoes R] [--aquecimento W] [--arquivo registros.bin]\n"
+               "                  [--csv saida.csv] [--cache-quente] [--tmp diretorio]\n");
+        return 1;
+    }
+
+    CabecalhoArquivo c;
+    consultar_binario(cfg.arquivo, &c);
+    if (c.quantidade <= 0) {
+        printf("Arquivo de registros vazio ou inexistente: %s\n", cfg.arquivo);
+        return 1;
+    }
+    int maior = 0;
+    for (int q = 0; q < cfg.num_quantidades; q++) {
+        if (cfg.quantidades[q] > c.quantidade) cfg.quantidades[q] = (int)c.quantidade;
+        if (cfg.quantidades[q] > maior) maior = cfg.quantidades[q];
+    }
+
+    // Entradas ordenadas preparadas uma única vez, com o maior N pedido
+    // (os prefixos de um arquivo ordenado também estão ordenados), em temporários que os
+    // filhos herdam: benchmarks simultâneos não compartilham as entradas preparadas
+    const char *arquivos[3] = {cfg.arquivo, NULL, NULL};
+    char caminhos[3][TAM_CAMINHO_TEMPORARIO];
+    int preparados[3] = {-1, -1, -1};
+    ResultadoExecucao r;
+    for (int e = 0; e < cfg.num_entradas; e++) {
+        int tipo = cfg.entradas[e];
+        if (arquivos[tipo]) continue;
+        preparados[tipo] = reservar_arquivo_temporario();
+        caminho_arquivo_temporario(preparados[tipo], caminhos[tipo], sizeof(caminhos[tipo]));
+        const char *destino = caminhos[tipo];
+        int ordem = (tipo == ENTRADA_ORDENADA_BENCH) ? ORDEM_ASCENDENTE : ORDEM_DESCENDENTE;
+        fprintf(stderr, "Preparando a entrada %s (%d registros)...\n", nomes_entrada[tipo], maior);
+        if (!executar_isolado(0, cfg.arquivo, destino, maior, ordem, 0, 0, &r)) {
+            printf("Falha ao preparar a entrada %s.\n", nomes_entrada[tipo]);
+            return 1;
+        }
+        arquivos[tipo] = destino;
+    }
+
+    FILE *csv = cfg.saida_csv ? abrir_arquivo(cfg.saida_csv, "w") : stdout;
+    fprintf(csv, "metodo,entrada,quantidade,situacao,bloco,memoria,repeticoes,mediana_s,p95_s,minimo_s,cpu_s,"
+                 "registros_por_s,mb_por_s,passadas,passadas_intercalacao,comparacoes,bytes_lidos,"
+                 "bytes_escritos,cache\n");
+
+    double *tempos = (double *)malloc(cfg.repeticoes * sizeof(double));
+    if (!tempos) {
+        perror("Erro ao alocar memória para o benchmark");
+        exit(EXIT_FAILURE);
+    }
+    int falhas = 0;
+
+    for (int mi = 0; mi < cfg.num_metodos; mi++)
+    for (int e = 0; e < cfg.num_entradas; e++)
+    for (int q = 0; q < cfg.num_quantidades; q++)
+    for (int s = 0; s < cfg.num_situacoes; s++)
+    for (int b = 0; b < cfg.num_blocos; b++)
+    for (int mm = 0; mm < cfg.num_memorias; mm++) {
+        int metodo = cfg.metodos[mi];
+        const char *arquivo = arquivos[cfg.entradas[e]];
+        int n = cfg.quantidades[q];
+        int situacao = cfg.situacoes[s];
+        int bloco = cfg.blocos[b];
+        long memoria = cfg.memorias[mm];
+        fprintf(stderr, "metodo %d, entrada %s, N = %d, situacao %d, bloco %d, memoria %ld\n",
+                metodo, nomes_entrada[cfg.entradas[e]], n, situacao, bloco, memoria);
+
+        int ok = 1;
+        int cache = 0;
+        for (int w = 0; w < cfg.aquecimento && ok; w++) {
+            ok = executar_isolado(metodo, arquivo, NULL, n, situacao, bloco, memoria, &r);
+        }
+        double cpu_total = 0.0;
+        for (int k = 0; k < cfg.repeticoes && ok; k++) {
+            if (cfg.cache_frio) cache = descartar_cache(arquivo);
+            ok = executar_isolado(metodo, arquivo, NULL, n, situacao, bloco, memoria, &r);
+            tempos[k] = r.tempo_parede;
+            cpu_total += r.tempo_cpu;
+        }
+        if (!ok) {
+            fprintf(stderr, "Falha na execução do método %d\n", metodo);
+            falhas++;
+            continue;
+        }
+
+        qsort(tempos, cfg.repeticoes, sizeof(double), comparar_tempos);
+        double mediana = (cfg.repeticoes % 2) ? tempos[cfg.repeticoes / 2]
+                       : (tempos[cfg.repeticoes / 2 - 1] + tempos[cfg.repeticoes / 2]) / 2.0;
+        double base = mediana > 0.0 ? mediana : 1e-9;
+        long leituras = r.stats.leituras_pre + r.stats.leituras_pos;
+        // Bloco efetivo: o pedido, o derivado do orçamento ou o padrão
+        int bloco_usado = bloco > 0 ? bloco : r.stats.bloco_plano > 0 ? r.stats.bloco_plano : TAM_BLOCO_PADRAO;
+        fprintf(csv, "%d,%s,%d,%d,%d,%ld,%d,%.6f,%.6f,%.6f,%.6f,%.0f,%.2f,%.2f,%d,%ld,%ld,%ld,%s\n",
+                metodo, nomes_entrada[cfg.entradas[e]], n, situacao, bloco_usado, memoria, cfg.repeticoes,
+                mediana, percentil(tempos, cfg.repeticoes, 95), tempos[0], cpu_total / cfg.repeticoes,
+                n / base, n * (double)sizeof(Registro) / base / 1e6, (double)leituras / n,
+                contar_passadas(&r.stats), r.stats.comparacoes_pre + r.stats.comparacoes_pos,
+                r.bytes_lidos, r.bytes_escritos,
+                !cfg.cache_frio ? "quente" : cache ? "frio" : "fadvise");
+        fflush(csv);
+    }
+
+    free(tempos);
+    if (csv != stdout) fechar_arquivo(csv);
+    for (int i = 0; i < 3; i++) {
+        if (preparados[i] >= 0) devolver_arquivo_temporario(preparados[i]);
+    }
+    return falhas > 0;
+}
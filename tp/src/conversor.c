@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/conversor.h"
+#include "../include/registro.h"
+#include "../include/fita.h"
+#include "../include/leitura.h"
+#include "../include/gravacao_paralela.h"
+
+#define TAM_MINIMO_TRECHO (1024 * 1024) // Trechos menores não compensam uma thread a mais
+
+// Trecho do arquivo texto interpretado por uma thread
+typedef struct {
+    TrechoBinario saida;  // Arquivo binário, posição do próximo registro do trecho e soma
+    const char *inicio;   // Primeiro caractere do trecho (sempre início de linha)
+    const char *fim;      // Fim do trecho (logo após um '\n' ou fim do arquivo)
+    long validos;         // Registros válidos no trecho (calculado na primeira fase)
+    long limite;          // Total de registros a gravar no arquivo binário
+} Trecho;
+
+// Interpreta um inteiro sem sinal no campo [p, p + largura), ignorando espaços à esquerda
+static long ler_inteiro(const char *p, int largura) {
+    int i = 0;
+    while (i < largura && p[i] == ' ') i++;
+    long valor = 0;
+    while (i < largura && p[i] >= '0' && p[i] <= '9') {
+        valor = valor * 10 + (p[i] - '0');
+        i++;
+    }
+    return valor;
+}
+
+// Interpreta a nota (parte inteira e decimal separadas por '.' ou ',').
+// A divisão de dois inteiros exatos em double é arredondada corretamente, como no atof.
+static float ler_nota(const char *p, int largura) {
+    int i = 0;
+    while (i < largura && p[i] == ' ') i++;
+    long mantissa = 0;
+    double divisor = 1.0;
+    int decimal = 0;
+    for (; i < largura; i++) {
+        if (p[i] >= '0' && p[i] <= '9') {
+            mantissa = mantissa * 10 + (p[i] - '0');
+            if (decimal) divisor *= 10.0;
+        } else if ((p[i] == '.' || p[i] == ',') && !decimal) {
+            decimal = 1;
+        } else {
+            break;
+        }
+    }
+    return (float)(mantissa / divisor);
+}
+
+// Copia o campo [coluna, coluna + largura) da linha sem os espaços das extremidades.
+// Linhas mais curtas que o campo (espaços finais removidos) resultam em campo parcial ou vazio.
+static void copiar_campo(char *destino, const char *linha, long tam_linha, int coluna, int largura) {
+    long ini = coluna;
+    long fim = coluna + largura;
+    if (fim > tam_linha) fim = tam_linha;
+    while (ini < fim && linha[ini] == ' ') ini++;
+    while (fim > ini && linha[fim - 1] == ' ') fim--;
+    long n = (fim > ini) ? fim - ini : 0;
+    memcpy(destino, linha + ini, n);
+    destino[n] = '\0';
+}
+
+// Retorna o tamanho da linha que começa em p (sem o fim de linha) e avança p para a próxima
+static long proxima_linha(const char **p, const char *fim) {
+    const char *linha = *p;
+    const char *quebra = memchr(linha, '\n', fim - linha);
+    *p = quebra ? quebra + 1 : fim;
+    long tam = (quebra ? quebra : fim) - linha;
+    if (tam > 0 && linha[tam - 1] == '\r') tam--;
+    return tam;
+}
+
+// Inscrição da linha, ou 0 se a linha não contém uma inscrição válida
+static long inscricao_linha(const char *linha, long tam) {
+    if (tam <= COL_INSCRICAO) return 0;
+    int largura = LARG_INSCRICAO;
+    if (COL_INSCRICAO + largura > tam) largura = (int)(tam - COL_INSCRICAO);
+    return ler_inteiro(linha + COL_INSCRICAO, largura);
+}
+
+// Primeira fase: conta as linhas válidas do trecho
+static void *contar_trecho(void *arg) {
+    Trecho *t = (Trecho *)arg;
+    const char *p = t->inicio;
+    t->validos = 0;
+    while (p < t->fim) {
+        const char *linha = p;
+        long tam = proxima_linha(&p, t->fim);
+        if (inscricao_linha(linha, tam) != 0) t->validos++;
+    }
+    return NULL;
+}
+
+// Segunda fase: interpreta as linhas válidas e grava os registros em blocos na posição final
+static void *converter_trecho(void *arg) {
+    Trecho *t = (Trecho *)arg;
+    int capacidade = registros_por_bloco();
+    Registro *bloco = (Registro *)calloc(capacidade, sizeof(Registro));
+    if (!bloco) {
+        perror("Erro ao alocar memória para a conversão");
+        exit(EXIT_FAILURE);
+    }
+
+    const char *p = t->inicio;
+    int n = 0;
+    while (p < t->fim && t->saida.destino + n < t->limite) {
+        const char *linha = p;
+        long tam = proxima_linha(&p, t->fim);
+        long inscricao = inscricao_linha(linha, tam);
+        if (inscricao == 0) continue;
+
+        Registro *r = &bloco[n++];
+        memset(r, 0, sizeof(Registro));
+        r->id = inscricao;
+        r->nota = (tam > COL_NOTA) ? ler_nota(linha + COL_NOTA, tam < COL_NOTA + LARG_NOTA ? (int)(tam - COL_NOTA) : LARG_NOTA) : 0.0f;
+        copiar_campo(r->estado, linha, tam, COL_ESTADO, LARG_ESTADO);
+        copiar_campo(r->cidade, linha, tam, COL_CIDADE, LARG_CIDADE);
+        copiar_campo(r->curso, linha, tam, COL_CURSO, LARG_CURSO);
+
+        if (n == capacidade) {
+            gravar_trecho(&t->saida, bloco, n);
+            n = 0;
+        }
+    }
+    if (n > 0) gravar_trecho(&t->saida, bloco, n);
+
+    free(bloco);
+    return NULL;
+}
+
+long converter_provao(const char *nome_texto, const char *nome_binario, long quantidade) {
+    int fd_texto = open(nome_texto, O_RDONLY);
+    struct stat st;
+    if (fd_texto < 0 || fstat(fd_texto, &st) < 0) {
+        perror("Erro ao abrir o arquivo texto");
+        exit(EXIT_FAILURE);
+    }
+    CabecalhoArquivo cabecalho;
+    int fd_binario = criar_binario_paralelo(nome_binario, &cabecalho);
+
+    size_t tamanho = st.st_size;
+    if (tamanho == 0) {
+        close(fd_texto);
+        close(fd_binario);
+        return 0;
+    }
+
+    const char *texto = (const char *)mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd_texto, 0);
+    if (texto == MAP_FAILED) {
+        perror("Erro ao mapear o arquivo texto");
+        exit(EXIT_FAILURE);
+    }
+    madvise((void *)texto, tamanho, MADV_SEQUENTIAL);
+    madvise((void *)texto, tamanho, MADV_WILLNEED);
+
+    // Um trecho por núcleo, cada um terminando logo após uma quebra de linha
+    int num_trechos = contar_trechos((long)tamanho, TAM_MINIMO_TRECHO, 0);
+
+    Trecho *trechos = (Trecho *)malloc(num_trechos * sizeof(Trecho));
+    if (!trechos) {
+        perror("Erro ao alocar memória para a conversão");
+        exit(EXIT_FAILURE);
+    }
+    const char *fim_texto = texto + tamanho;
+    const char *inicio = texto;
+    for (int i = 0; i < num_trechos; i++) {
+        const char *fim = (i == num_trechos - 1) ? fim_texto : texto + tamanho / num_trechos * (i + 1);
+        if (fim < inicio) fim = inicio;
+        if (fim < fim_texto && fim > texto && fim[-1] != '\n') {
+            const char *quebra = memchr(fim, '\n', fim_texto - fim);
+            fim = quebra ? quebra + 1 : fim_texto;
+        }
+        trechos[i].inicio = inicio;
+        trechos[i].fim = fim;
+        trechos[i].saida.fd = fd_binario;
+        trechos[i].saida.soma = 0;
+        inicio = fim;
+    }
+
+    // Primeira fase: contagem; a soma de prefixos dá a posição de cada trecho no arquivo binário
+    executar_trechos(trechos, num_trechos, sizeof(Trecho), contar_trecho);
+    long total = 0;
+    for (int i = 0; i < num_trechos; i++) {
+        trechos[i].saida.destino = total;
+        total += trechos[i].validos;
+    }
+    if (quantidade > 0 && quantidade < total) total = quantidade;
+    for (int i = 0; i < num_trechos; i++) {
+        trechos[i].limite = total;
+    }
+
+    // Segunda fase: interpretação e gravação em paralelo
+    executar_trechos(trechos, num_trechos, sizeof(Trecho), converter_trecho);
+
+    finalizar_binario_paralelo(fd_binario, &cabecalho, total, trechos, num_trechos, sizeof(Trecho));
+
+    free(trechos);
+    munmap((void *)texto, tamanho);
+    close(fd_texto);
+    return total;
+}
@@ -0,0 +1,404 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/fita.h"
+#include "../include/leitura.h"
+#include "../include/utils.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+
+// A fita e o buffer do seu bloco vêm de uma única reserva temporária, com o bloco
+// começando na linha de cache seguinte à estrutura
+#define TAM_ESTRUTURA_FITA ((sizeof(Fita) + ALINHAMENTO_ARENA - 1) / ALINHAMENTO_ARENA * ALINHAMENTO_ARENA)
+
+static int tamanho_bloco = TAM_BLOCO_PADRAO; // Em bytes
+static int bloco_explicito = 0;              // 1 depois de definir_tamanho_bloco
+static int entrada_mapeada = 0;              // Ver definir_entrada_mapeada
+static TratadorErroFita tratador_erro = NULL;
+
+TratadorErroFita definir_tratador_erro_fita(TratadorErroFita tratador) {
+    TratadorErroFita anterior = tratador_erro;
+    tratador_erro = tratador;
+    return anterior;
+}
+
+// Entrega a falha ao tratador, se houver; senão, encerra o programa
+static void falha_fita(const char *mensagem) {
+    if (tratador_erro) tratador_erro(mensagem);
+    perror(mensagem);
+    exit(EXIT_FAILURE);
+}
+
+void definir_tamanho_bloco(int bytes) {
+    tamanho_bloco = bytes;
+    bloco_explicito = 1;
+}
+
+void ajustar_tamanho_bloco(int bytes) {
+    tamanho_bloco = bytes;
+}
+
+int tamanho_bloco_atual(void) {
+    return tamanho_bloco;
+}
+
+int bloco_definido(void) {
+    return bloco_explicito;
+}
+
+int itens_por_bloco(int tam_item) {
+    int n = tamanho_bloco / tam_item;
+    return n > 0 ? n : 1;
+}
+
+long bytes_fita(int tam_item) {
+    long bytes = TAM_ESTRUTURA_FITA + (long)itens_por_bloco(tam_item) * tam_item;
+    return (bytes + ALINHAMENTO_ARENA - 1) / ALINHAMENTO_ARENA * ALINHAMENTO_ARENA;
+}
+
+int registros_por_bloco(void) {
+    return itens_por_bloco((int)sizeof(Registro));
+}
+
+// Transfere 'bytes' bytes a partir do deslocamento indicado, repetindo a chamada em caso de
+// transferência parcial. Retorna quantos bytes foram transferidos (menos que o pedido só no fim do arquivo).
+static long transferir(int fd, void *buffer, long bytes, long deslocamento, int escrever) {
+    long feito = 0;
+    while (feito < bytes) {
+        ssize_t r = escrever ? pwrite(fd, (char *)buffer + feito, bytes - feito, deslocamento + feito)
+                             : pread(fd, (char *)buffer + feito, bytes - feito, deslocamento + feito);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            falha_fita(escrever ? "Erro ao escrever na fita" : "Erro ao ler a fita");
+        }
+        if (r == 0) break;
+        feito += r;
+    }
+    registrar_bytes(escrever ? 0 : feito, escrever ? feito : 0);
+    return feito;
+}
+
+// Cria a fita sobre um descritor já aberto, que passa a pertencer a ela
+static Fita *criar_fita(int fd, int modo, long inicio, int reverso, int tam_item, long *contador_blocos) {
+    int capacidade = itens_por_bloco(tam_item);
+    Fita *f = (Fita *)alocar_temporario(TAM_ESTRUTURA_FITA + (size_t)capacidade * tam_item);
+    if (!f) {
+        close(fd);
+        falha_fita("Erro ao alocar memória para a fita");
+    }
+    Registro *bloco = (Registro *)((char *)f + TAM_ESTRUTURA_FITA);
+
+    f->fd = fd;
+    f->modo = modo;
+    f->reverso = reverso;
+    f->bloco = bloco;
+    f->tam_item = tam_item;
+    f->mapa = NULL;
+    f->total_mapa = 0;
+    f->capacidade = capacidade;
+    f->n = 0;
+    f->proximo = inicio;
+    f->restantes = -1;
+    f->contador_blocos = contador_blocos;
+    // Só os arquivos de registros têm cabeçalho
+    CabecalhoArquivo c;
+    f->base = (tam_item == (int)sizeof(Registro) && ler_cabecalho(fd, &c)) ? (long)c.tam_cabecalho : 0;
+    f->cabecalho = 0;
+    f->escritos = 0;
+    f->soma = 0;
+    f->temporario = -1;
+    // No modo reverso o buffer é percorrido do fim para o início
+    if (reverso) {
+        f->pos = (modo == FITA_ESCRITA) ? capacidade - 1 : -1;
+    } else {
+        f->pos = 0;
+    }
+    return f;
+}
+
+Fita *abrir_fita_em(const char *nome, int modo, long inicio, int reverso, long *contador_blocos) {
+    // A escrita também lê o início do arquivo para localizar o cabeçalho
+    int flags = (modo == FITA_LEITURA) ? O_RDONLY : (O_RDWR | O_CREAT);
+    int fd = open(nome, flags, 0644);
+    if (fd < 0) falha_fita("Erro ao abrir a fita");
+    return criar_fita(fd, modo, inicio, reverso, (int)sizeof(Registro), contador_blocos);
+}
+
+// Fita sobre uma cópia do descritor de um arquivo temporário; a escrita trunca o arquivo
+static Fita *criar_fita_temporaria(int arquivo, int modo, long inicio, int tam_item, long *contador_blocos) {
+    int fd = dup(descritor_arquivo_temporario(arquivo));
+    if (fd < 0 || (modo == FITA_ESCRITA && ftruncate(fd, 0) != 0)) {
+        if (fd >= 0) close(fd);
+        falha_fita("Erro ao abrir a fita");
+    }
+    Fita *f = criar_fita(fd, modo, inicio, 0, tam_item, contador_blocos);
+    f->temporario = arquivo;
+    return f;
+}
+
+Fita *abrir_fita_itens(int arquivo, int modo, int tam_item, long *contador_blocos) {
+    return criar_fita_temporaria(arquivo, modo, 0, tam_item, contador_blocos);
+}
+
+Fita *abrir_fita_temporaria(int arquivo, int modo, long *contador_blocos) {
+    Fita *f = criar_fita_temporaria(arquivo, modo, 0, (int)sizeof(Registro), contador_blocos);
+    if (modo == FITA_ESCRITA) {
+        f->base = TAM_CABECALHO;
+        f->cabecalho = 1;
+    }
+    return f;
+}
+
+Fita *abrir_fita_temporaria_em(int arquivo, long inicio, long *contador_blocos) {
+    return criar_fita_temporaria(arquivo, FITA_LEITURA, inicio, (int)sizeof(Registro), contador_blocos);
+}
+
+Fita *abrir_fita(const char *nome, int modo, long *contador_blocos) {
+    if (modo == FITA_ESCRITA) {
+        // Cria ou trunca o arquivo antes de abrir a fita
+        int fd = open(nome, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) falha_fita("Erro ao abrir a fita");
+        close(fd);
+        Fita *f = abrir_fita_em(nome, modo, 0, 0, contador_blocos);
+        f->base = TAM_CABECALHO;
+        f->cabecalho = 1;
+        return f;
+    }
+    return abrir_fita_em(nome, modo, 0, 0, contador_blocos);
+}
+
+void limitar_fita(Fita *f, long quantidade) {
+    f->restantes = quantidade;
+}
+
+void definir_entrada_mapeada(int ativa) {
+    entrada_mapeada = ativa;
+}
+
+int entrada_mapeada_ativa(void) {
+    return entrada_mapeada;
+}
+
+Fita *abrir_fita_entrada(const char *nome, long *contador_blocos) {
+    if (!entrada_mapeada) {
+        return abrir_fita(nome, FITA_LEITURA, contador_blocos);
+    }
+
+    const ArquivoMapeado *arq = mapear_binario(nome);
+    Fita *f = (Fita *)alocar_temporario(sizeof(Fita));
+    if (!f) falha_fita("Erro ao alocar memória para a fita");
+    f->fd = -1;
+    f->modo = FITA_LEITURA;
+    f->reverso = 0;
+    f->bloco = NULL;
+    f->tam_item = (int)sizeof(Registro);
+    f->mapa = arq->registros;
+    f->total_mapa = arq->quantidade;
+    f->capacidade = registros_por_bloco();
+    f->pos = 0;
+    f->n = 0;
+    f->proximo = 0;
+    f->restantes = -1;
+    f->contador_blocos = contador_blocos;
+    f->base = 0;
+    f->cabecalho = 0;
+    f->escritos = 0;
+    f->soma = 0;
+    f->temporario = -1;
+    return f;
+}
+
+// Carrega o próximo bloco do arquivo no buffer; retorna o número de registros carregados
+static int recarregar_fita(Fita *f) {
+    long quantidade = f->capacidade;
+    if (f->restantes >= 0 && f->restantes < quantidade) {
+        quantidade = f->restantes;
+    }
+    if (f->reverso && f->proximo + 1 < quantidade) {
+        quantidade = f->proximo + 1;
+    }
+    if (f->mapa && f->total_mapa - f->proximo < quantidade) {
+        quantidade = f->total_mapa - f->proximo;
+    }
+    if (quantidade <= 0) return 0;
+
+    // Fita mapeada: o "bloco" é apenas uma janela sobre o mapeamento
+    if (f->mapa) {
+        f->bloco = (Registro *)(f->mapa + f->proximo);
+        f->n = (int)quantidade;
+        f->pos = 0;
+        f->proximo += quantidade;
+        if (f->restantes >= 0) f->restantes -= quantidade;
+        if (f->contador_blocos) (*f->contador_blocos)++;
+        registrar_bytes(quantidade * (long)sizeof(Registro), 0);
+        return f->n;
+    }
+
+    long inicio = f->reverso ? f->proximo - quantidade + 1 : f->proximo;
+
+    long bytes = transferir(f->fd, f->bloco, quantidade * f->tam_item, f->base + inicio * f->tam_item, 0);
+    f->n = (int)(bytes / f->tam_item);
+    if (f->n > 0 && f->contador_blocos) (*f->contador_blocos)++;
+    if (f->restantes >= 0) f->restantes -= f->n;
+
+    if (f->reverso) {
+        f->pos = f->n - 1;
+        f->proximo = inicio - 1;
+    } else {
+        f->pos = 0;
+        f->proximo += f->n;
+    }
+    return f->n;
+}
+
+int ler_fita(Fita *f, Registro *r) {
+    if (f->reverso) {
+        if (f->pos < 0 && recarregar_fita(f) == 0) return 0;
+        *r = f->bloco[f->pos--];
+        return 1;
+    }
+
+    if (f->pos >= f->n && recarregar_fita(f) == 0) return 0;
+    *r = f->bloco[f->pos++];
+    return 1;
+}
+
+const Registro *espiar_registros_fita(Fita *f, int n, int *obtidos) {
+    *obtidos = 0;
+    if (!f->mapa) return NULL;
+
+    // Consome primeiro o que restar da janela atual
+    if (f->pos < f->n) {
+        int disponiveis = f->n - f->pos;
+        if (n < disponiveis) disponiveis = n;
+        const Registro *inicio = &f->bloco[f->pos];
+        f->pos += disponiveis;
+        *obtidos = disponiveis;
+        return inicio;
+    }
+
+    // Depois avança direto no mapeamento, sem o limite de um bloco
+    long quantidade = f->total_mapa - f->proximo;
+    if (f->restantes >= 0 && f->restantes < quantidade) quantidade = f->restantes;
+    if (n < quantidade) quantidade = n;
+    if (quantidade <= 0) return NULL;
+
+    const Registro *inicio = f->mapa + f->proximo;
+    f->proximo += quantidade;
+    if (f->restantes >= 0) f->restantes -= quantidade;
+    if (f->contador_blocos) {
+        *f->contador_blocos += (quantidade + f->capacidade - 1) / f->capacidade;
+    }
+    registrar_bytes(quantidade * (long)sizeof(Registro), 0);
+    *obtidos = (int)quantidade;
+    return inicio;
+}
+
+int ler_registros_fita(Fita *f, Registro *v, int n) {
+    if (f->reverso) {
+        int lidos = 0;
+        while (lidos < n && ler_fita(f, &v[lidos])) lidos++;
+        return lidos;
+    }
+
+    int lidos = 0;
+    while (lidos < n) {
+        if (f->pos >= f->n && recarregar_fita(f) == 0) break;
+        int disponiveis = f->n - f->pos;
+        int copiar = (n - lidos < disponiveis) ? n - lidos : disponiveis;
+        memcpy(&v[lidos], &f->bloco[f->pos], copiar * sizeof(Registro));
+        f->pos += copiar;
+        lidos += copiar;
+    }
+    return lidos;
+}
+
+// Grava no arquivo os registros pendentes no buffer
+static void descarregar_fita(Fita *f) {
+    if (f->reverso) {
+        int pendentes = f->capacidade - 1 - f->pos;
+        if (pendentes == 0) return;
+        long inicio = f->proximo - pendentes + 1;
+        transferir(f->fd, &f->bloco[f->pos + 1], pendentes * sizeof(Registro), f->base + inicio * sizeof(Registro), 1);
+        f->proximo = inicio - 1;
+        f->pos = f->capacidade - 1;
+    } else {
+        if (f->pos == 0) return;
+        if (f->cabecalho) {
+            f->soma += soma_registros(f->bloco, f->pos);
+            f->escritos += f->pos;
+        }
+        transferir(f->fd, f->bloco, (long)f->pos * f->tam_item, f->base + f->proximo * f->tam_item, 1);
+        f->proximo += f->pos;
+        f->pos = 0;
+    }
+    if (f->contador_blocos) (*f->contador_blocos)++;
+}
+
+void escrever_fita(Fita *f, const Registro *r) {
+    if (f->reverso) {
+        f->bloco[f->pos--] = *r;
+        if (f->pos < 0) descarregar_fita(f);
+        return;
+    }
+
+    f->bloco[f->pos++] = *r;
+    if (f->pos == f->capacidade) descarregar_fita(f);
+}
+
+void escrever_registros_fita(Fita *f, const Registro *v, int n) {
+    if (f->reverso) {
+        for (int i = 0; i < n; i++) escrever_fita(f, &v[i]);
+        return;
+    }
+
+    int escritos = 0;
+    while (escritos < n) {
+        int livres = f->capacidade - f->pos;
+        int copiar = (n - escritos < livres) ? n - escritos : livres;
+        memcpy(&f->bloco[f->pos], &v[escritos], copiar * sizeof(Registro));
+        f->pos += copiar;
+        escritos += copiar;
+        if (f->pos == f->capacidade) descarregar_fita(f);
+    }
+}
+
+int ler_item_fita(Fita *f, void *item) {
+    if (f->pos >= f->n && recarregar_fita(f) == 0) return 0;
+    memcpy(item, (char *)f->bloco + (long)f->pos++ * f->tam_item, f->tam_item);
+    return 1;
+}
+
+void escrever_item_fita(Fita *f, const void *item) {
+    memcpy((char *)f->bloco + (long)f->pos++ * f->tam_item, item, f->tam_item);
+    if (f->pos == f->capacidade) descarregar_fita(f);
+}
+
+void fechar_fita(Fita *f) {
+    if (!f) return;
+    if (f->mapa) {
+        liberar_temporario(f); // O mapeamento pertence ao processo (ver mapear_binario)
+        return;
+    }
+    if (f->modo == FITA_ESCRITA) descarregar_fita(f);
+    if (f->cabecalho) {
+        CabecalhoArquivo c;
+        iniciar_cabecalho(&c);
+        c.quantidade = f->escritos;
+        c.soma = f->soma;
+        if (!gravar_cabecalho(f->fd, &c)) falha_fita("Erro ao gravar o cabeçalho");
+    }
+    close(f->fd);
+    if (f->temporario >= 0) registrar_uso_arquivo_temporario(f->temporario);
+    liberar_temporario(f); // Libera também o bloco
+}
+
+void descartar_fita(Fita *f) {
+    if (!f) return;
+    if (f->fd >= 0) close(f->fd);
+    if (f->temporario >= 0) registrar_uso_arquivo_temporario(f->temporario);
+    liberar_temporario(f);
+}
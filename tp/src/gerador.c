@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/gerador.h"
+#include "../include/registro.h"
+#include "../include/leitura.h"
+#include "../include/gravacao_paralela.h"
+
+static const char *nomes_distribuicao[] = {"ordenada", "inversa", "aleatoria", "duplicadas", "zipf", "ruido"};
+
+static const char *estados[] = {"AC", "AL", "AM", "AP", "BA", "CE", "DF", "ES", "GO", "MA", "MG", "MS", "MT", "PA",
+                                "PB", "PE", "PI", "PR", "RJ", "RN", "RO", "RR", "RS", "SC", "SE", "SP", "TO"};
+static const char *cidades[] = {"BELO HORIZONTE", "SAO PAULO", "RIO DE JANEIRO", "SALVADOR", "FORTALEZA",
+                                "CURITIBA", "RECIFE", "PORTO ALEGRE", "VICOSA", "JUIZ DE FORA"};
+static const char *cursos[] = {"CIENCIA DA COMPUTACAO", "DIREITO", "MEDICINA", "ADMINISTRACAO", "ENGENHARIA CIVIL",
+                               "LETRAS", "MATEMATICA", "PSICOLOGIA"};
+
+#define NUM_ESTADOS (int)(sizeof(estados) / sizeof(estados[0]))
+#define NUM_CIDADES (int)(sizeof(cidades) / sizeof(cidades[0]))
+#define NUM_CURSOS (int)(sizeof(cursos) / sizeof(cursos[0]))
+
+// Trecho contíguo do arquivo gerado por uma thread
+typedef struct {
+    TrechoBinario saida;          // Arquivo gerado, posição do próximo registro do trecho e soma
+    long primeiro;                // Posição do primeiro registro do trecho
+    long quantidade;              // Registros do trecho
+    long total;                   // Registros do arquivo inteiro
+    long valores;                 // Notas possíveis (NOTA_MAXIMA * escala + 1)
+    double escala;                // 10^casas
+    const double *acumulada;      // Distribuição acumulada de Zipf (NULL nas demais)
+    const ParametrosGerador *p;
+} TrechoGerado;
+
+void iniciar_parametros_gerador(ParametrosGerador *p) {
+    p->distribuicao = DIST_ALEATORIA;
+    p->semente = 42;
+    p->casas = 1;
+    p->distintos = 10;
+    p->expoente = 1.0;
+    p->ruido = 5.0;
+    p->threads = 0;
+}
+
+int distribuicao_por_nome(const char *nome) {
+    for (int i = 0; i < (int)(sizeof(nomes_distribuicao) / sizeof(nomes_distribuicao[0])); i++) {
+        if (strcmp(nome, nomes_distribuicao[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Hash de 64 bits (finalizador do splitmix64): valores pseudoaleatórios independentes
+// para cada par (semente, contador), sem estado compartilhado entre as threads
+static uint64_t misturar(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Índice do valor de 'k' (0 a n - 1) espalhado sobre as 'valores' notas possíveis
+static long espalhar(long k, long n, long valores) {
+    return (n > 1) ? (long)((double)k * (valores - 1) / (n - 1)) : valores / 2;
+}
+
+// Índice da nota do registro i (0 a valores - 1)
+static long indice_nota(const TrechoGerado *t, long i, uint64_t aleatorio, uint64_t extra) {
+    long valores = t->valores;
+    long crescente = espalhar(i, t->total, valores);
+    switch (t->p->distribuicao) {
+        case DIST_ORDENADA:
+            return crescente;
+        case DIST_INVERSA:
+            return valores - 1 - crescente;
+        case DIST_DUPLICADAS:
+            return espalhar((long)(aleatorio % (uint64_t)t->p->distintos), t->p->distintos, valores);
+        case DIST_ZIPF: {
+            // Busca binária do posto na distribuição acumulada
+            double u = (aleatorio >> 11) * (1.0 / 9007199254740992.0);
+            long ini = 0, fim = t->p->distintos - 1;
+            while (ini < fim) {
+                long meio = (ini + fim) / 2;
+                if (t->acumulada[meio] < u) ini = meio + 1;
+                else fim = meio;
+            }
+            return espalhar(ini, t->p->distintos, valores);
+        }
+        case DIST_RUIDO:
+            if ((extra >> 11) * (100.0 / 9007199254740992.0) < t->p->ruido) {
+                return (long)(aleatorio % (uint64_t)valores);
+            }
+            return crescente;
+        default:
+            return (long)(aleatorio % (uint64_t)valores);
+    }
+}
+
+// Constantes dos fluxos pseudoaleatórios de um registro. A base é um contador do splitmix64
+// (distinta para cada registro) e cada fluxo a mistura com a sua constante; a base do registro
+// seguinte não é mais base + 1, então os fluxos de registros vizinhos não se repetem.
+#define FLUXO_NOTA 0x243f6a8885a308d3ULL
+#define FLUXO_RUIDO 0x13198a2e03707344ULL
+#define FLUXO_CAMPOS 0xa4093822299f31d0ULL
+
+static void gerar_registro(const TrechoGerado *t, long i, Registro *r) {
+    uint64_t base = misturar(t->p->semente + (uint64_t)i * 0x9e3779b97f4a7c15ULL);
+    uint64_t aleatorio = misturar(base ^ FLUXO_NOTA);
+    uint64_t extra = misturar(base ^ FLUXO_RUIDO);
+    uint64_t campos = misturar(base ^ FLUXO_CAMPOS);
+
+    memset(r, 0, sizeof(Registro));
+    r->id = i + 1;
+    r->nota = (float)(indice_nota(t, i, aleatorio, extra) / t->escala);
+    memcpy(r->estado, estados[campos % NUM_ESTADOS], 2);
+    strcpy(r->cidade, cidades[(campos >> 16) % NUM_CIDADES]);
+    strcpy(r->curso, cursos[(campos >> 32) % NUM_CURSOS]);
+}
+
+// Gera os registros do trecho em um buffer e os grava na posição final do arquivo
+static void *gerar_trecho(void *arg) {
+    TrechoGerado *t = (TrechoGerado *)arg;
+    long capacidade = TAM_BUFFER_GERACAO / (long)sizeof(Registro);
+    Registro *buffer = (Registro *)malloc(capacidade * sizeof(Registro));
+    if (!buffer) {
+        perror("Erro ao alocar memória para a geração");
+        exit(EXIT_FAILURE);
+    }
+
+    for (long feito = 0; feito < t->quantidade; ) {
+        long n = t->quantidade - feito;
+        if (n > capacidade) n = capacidade;
+        for (long k = 0; k < n; k++) {
+            gerar_registro(t, t->primeiro + feito + k, &buffer[k]);
+        }
+        gravar_trecho(&t->saida, buffer, n);
+        feito += n;
+    }
+
+    free(buffer);
+    return NULL;
+}
+
+// Distribuição acumulada de Zipf sobre n postos: P(posto k) proporcional a 1 / (k + 1)^s
+static double *acumular_zipf(long n, double expoente) {
+    double *acumulada = (double *)malloc(n * sizeof(double));
+    if (!acumulada) {
+        perror("Erro ao alocar memória para a distribuição de Zipf");
+        exit(EXIT_FAILURE);
+    }
+    double soma = 0.0;
+    for (long k = 0; k < n; k++) {
+        soma += 1.0 / pow((double)(k + 1), expoente);
+        acumulada[k] = soma;
+    }
+    for (long k = 0; k < n; k++) {
+        acumulada[k] /= soma;
+    }
+    acumulada[n - 1] = 1.0;
+    return acumulada;
+}
+
+void gerar_registros(const char *nome_binario, long quantidade, const ParametrosGerador *p) {
+    CabecalhoArquivo cabecalho;
+    int fd = criar_binario_paralelo(nome_binario, &cabecalho);
+
+    double escala = 1.0;
+    for (int c = 0; c < p->casas; c++) escala *= 10.0;
+    long valores = (long)(NOTA_MAXIMA * escala) + 1;
+    ParametrosGerador param = *p;
+    if (param.distintos < 1) param.distintos = 1;
+    if (param.distintos > valores) param.distintos = valores;
+    double *acumulada = (param.distribuicao == DIST_ZIPF) ? acumular_zipf(param.distintos, param.expoente) : NULL;
+
+    // Um trecho contíguo por thread
+    int num_trechos = contar_trechos(quantidade, MIN_REGISTROS_TRECHO, param.threads);
+
+    TrechoGerado *trechos = (TrechoGerado *)malloc(num_trechos * sizeof(TrechoGerado));
+    if (!trechos) {
+        perror("Erro ao alocar memória para a geração");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_trechos; i++) {
+        trechos[i].primeiro = quantidade * i / num_trechos;
+        trechos[i].quantidade = quantidade * (i + 1) / num_trechos - trechos[i].primeiro;
+        trechos[i].total = quantidade;
+        trechos[i].valores = valores;
+        trechos[i].escala = escala;
+        trechos[i].acumulada = acumulada;
+        trechos[i].p = &param;
+        trechos[i].saida.fd = fd;
+        trechos[i].saida.destino = trechos[i].primeiro;
+        trechos[i].saida.soma = 0;
+    }
+    executar_trechos(trechos, num_trechos, sizeof(TrechoGerado), gerar_trecho);
+
+    finalizar_binario_paralelo(fd, &cabecalho, quantidade, trechos, num_trechos, sizeof(TrechoGerado));
+
+    free(acumulada);
+    free(trechos);
+}
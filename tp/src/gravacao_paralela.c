@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/gravacao_paralela.h"
+
+int contar_trechos(long tamanho, long minimo, int threads) {
+    long nucleos = (threads > 0) ? threads : sysconf(_SC_NPROCESSORS_ONLN);
+    long max_trechos = (tamanho + minimo - 1) / minimo;
+    int num_trechos = (int)(nucleos < 1 ? 1 : nucleos);
+    if (num_trechos > max_trechos) num_trechos = (int)(max_trechos > 0 ? max_trechos : 1);
+    return num_trechos;
+}
+
+void executar_trechos(void *trechos, int num_trechos, size_t tam_trecho, void *(*funcao)(void *)) {
+    pthread_t *threads = (pthread_t *)malloc(num_trechos * sizeof(pthread_t));
+    if (!threads) {
+        perror("Erro ao alocar memória para as threads");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_trechos; i++) {
+        if (pthread_create(&threads[i], NULL, funcao, (char *)trechos + i * tam_trecho) != 0) {
+            perror("Erro ao criar thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < num_trechos; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+}
+
+void gravar_trecho(TrechoBinario *t, const Registro *v, long n) {
+    long bytes = n * (long)sizeof(Registro);
+    if (pwrite(t->fd, v, bytes, TAM_CABECALHO + t->destino * (long)sizeof(Registro)) != bytes) {
+        perror("Erro ao gravar o arquivo binário");
+        exit(EXIT_FAILURE);
+    }
+    t->soma += soma_registros(v, n);
+    t->destino += n;
+}
+
+int criar_binario_paralelo(const char *nome_binario, CabecalhoArquivo *cabecalho) {
+    int fd = open(nome_binario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("Erro ao criar o arquivo binário");
+        exit(EXIT_FAILURE);
+    }
+    iniciar_cabecalho(cabecalho);
+    escrever_cabecalho(fd, cabecalho);
+    return fd;
+}
+
+void finalizar_binario_paralelo(int fd, CabecalhoArquivo *cabecalho, long quantidade,
+                                const void *trechos, int num_trechos, size_t tam_trecho) {
+    // A soma de verificação não depende da ordem, então as somas dos trechos se acumulam
+    cabecalho->quantidade = quantidade;
+    for (int i = 0; i < num_trechos; i++) {
+        cabecalho->soma += ((const TrechoBinario *)((const char *)trechos + i * tam_trecho))->soma;
+    }
+    escrever_cabecalho(fd, cabecalho);
+    close(fd);
+}
@@ -1,8 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../include/intercalacao1f.h"
+#include "../include/intercalacao2f.h"
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/ordenacao_interna.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
 
+// Abre as num_fitas fitas de entrada, sobre os arquivos temporários indicados, no modo pedido
+static void abrir_fitas_entrada(Fita **fitas, const int *arquivos, int num_fitas, int modo, long *contador_blocos) {
+    for (int i = 0; i < num_fitas; i++) {
+        fitas[i] = abrir_fita_temporaria(arquivos[i], modo, contador_blocos);
+    }
+}
+
+// Fecha as num_fitas fitas de entrada
+static void fechar_fitas_entrada(Fita **fitas, int num_fitas) {
+    for (int i = 0; i < num_fitas; i++) {
+        fechar_fita(fitas[i]);
+        fitas[i] = NULL;
+    }
+}
+
+// Redistribui as corridas da fita de saída alternadamente nas fitas de entrada
+static void redistribuir_corridas_1f(Fita *saida, Fita **fitas, int num_fitas, Metricas *stats, int ordem) {
+    Registro reg;
+    int fita = 0;
+    int tem_anterior = 0;
+    float anterior = 0.0f;
+
+    while (ler_fita(saida, &reg)) {
+        stats->leituras_pos++;
+        if (tem_anterior) {
+            stats->comparacoes_pos++;
+            if (quebra_ordem(anterior, reg.nota, ordem)) {
+                fita = (fita + 1) % num_fitas;
+            }
+        }
+        escrever_fita(fitas[fita], &reg);
+        stats->escritas_pos++;
+        anterior = reg.nota;
+        tem_anterior = 1;
+    }
+}
 
-void intercalacao_balanceada_1f(const char *arquivo, int n, int situacao) {
-  return;
+// Plano de memória da intercalação F+1: registros e pares de ordenação na geração de corridas,
+// ao lado da entrada e das fitas de entrada; na intercalação, uma fita e o estado de cada via
+// mais a fita de saída
+static void planejar_1f(int quantidade, PlanoMemoria *plano, Metricas *stats) {
+    RequisitosMemoria req = {MAX_REGISTROS_1F, sizeof(Registro) + 2 * sizeof(ChaveRadix), 0, 1, 1, 1,
+                             sizeof(EstadoFita) + BYTES_FOLHA_ARVORE, NUM_FITAS_1F - 1};
+    planejar_memoria(&req, quantidade, plano, stats);
 }
 
+// Intercalação balanceada de F+1 fitas: F fitas de entrada e uma fita de saída.
+// A cada passada, F corridas são intercaladas na fita de saída, cujas corridas
+// são depois redistribuídas entre as F fitas de entrada, até restar uma única corrida.
+// F é escolhido em tempo de execução a partir do plano de memória (sem --mem, um registro por
+// fita de entrada cabe em MAX_REGISTROS_1F).
+static void ordenar_1f(const char *arquivo, const char *destino, int quantidade, Metricas *stats, int ordem) {
+    Fita *fitas[NUM_FITAS_1F];
+    int arquivos[NUM_FITAS_1F]; // Arquivos temporários das fitas de entrada
+    Cronometro inicio, fim;
+
+    PlanoMemoria plano;
+    planejar_1f(quantidade, &plano, stats);
+    int tam_memoria = plano.memoria;
+
+    // Estimativa pessimista do número de corridas: uma por memória cheia
+    int num_fitas = calcular_fan_in(plano.fan_in, (quantidade + tam_memoria - 1) / tam_memoria);
+    if (num_fitas > NUM_FITAS_1F - 1) {
+        num_fitas = NUM_FITAS_1F - 1;
+    }
+    for (int i = 0; i < num_fitas; i++) arquivos[i] = reservar_arquivo_temporario();
+    int arquivo_saida = reservar_arquivo_temporario();
+    long marca = marcar_arena(); // Restaurada ao fim de cada fase
+
+    // Pré-processamento: geração das corridas iniciais
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "corridas");
+    Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pre);
+    abrir_fitas_entrada(fitas, arquivos, num_fitas, FITA_ESCRITA, &stats->blocos_escritos_pre);
+    int num_corridas = gerar_corridas(entrada, quantidade, fitas, num_fitas,
+                                      tam_memoria, stats, ordem);
+    fechar_fita(entrada);
+    fechar_fitas_entrada(fitas, num_fitas);
+    restaurar_arena(marca);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+    // Intercalação: repete as passadas até que reste apenas uma corrida
+    iniciar_tempo(&inicio);
+    if (num_corridas <= 1) {
+        // A única corrida (se houver) já está na primeira fita, que passa a ser a de saída
+        int troca = arquivo_saida;
+        arquivo_saida = arquivos[0];
+        arquivos[0] = troca;
+    } else {
+        for (int passada = 1; ; passada++) {
+            char nome_fase[TAM_NOME_FASE];
+            snprintf(nome_fase, sizeof(nome_fase), "passada %d", passada);
+            iniciar_fase(stats, nome_fase);
+            abrir_fitas_entrada(fitas, arquivos, num_fitas, FITA_LEITURA, &stats->blocos_lidos_pos);
+            Fita *saida = abrir_fita_temporaria(arquivo_saida, FITA_ESCRITA, &stats->blocos_escritos_pos);
+            int corridas_saida = intercalar_fitas(fitas, num_fitas, &saida, 1, NULL, stats, ordem);
+            fechar_fitas_entrada(fitas, num_fitas);
+            fechar_fita(saida);
+            restaurar_arena(marca);
 
+            if (corridas_saida <= 1) {
+                break;
+            }
+
+            snprintf(nome_fase, sizeof(nome_fase), "redistribuicao %d", passada);
+            iniciar_fase(stats, nome_fase);
+            saida = abrir_fita_temporaria(arquivo_saida, FITA_LEITURA, &stats->blocos_lidos_pos);
+            abrir_fitas_entrada(fitas, arquivos, num_fitas, FITA_ESCRITA, &stats->blocos_escritos_pos);
+            redistribuir_corridas_1f(saida, fitas, num_fitas, stats, ordem);
+            fechar_fitas_entrada(fitas, num_fitas);
+            fechar_fita(saida);
+            restaurar_arena(marca);
+        }
+    }
+    finalizar_fase(stats);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+
+    // A fita de saída contém o arquivo ordenado; as fitas de entrada são devolvidas
+    exportar_arquivo_temporario(arquivo_saida, destino);
+    for (int i = 0; i < num_fitas; i++) {
+        devolver_arquivo_temporario(arquivos[i]);
+    }
+}
+
+void intercalacao_balanceada_1f(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
+    int ordem = ordem_da_situacao(situacao);
+    Cronometro inicio, fim;
+    PlanoMemoria plano;
+    planejar_1f(quantidade, &plano, stats);
+
+    // A saída é preparada em um temporário e só vai para o destino no fim
+    char saida[TAM_CAMINHO_TEMPORARIO];
+    int arquivo_saida = preparar_saida(saida);
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): basta copiá-la
+    iniciar_tempo(&inicio);
+    if (copiar_se_ordenado(arquivo, saida, quantidade, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else if (!ordenar_adaptativo(arquivo, saida, quantidade, plano.memoria,
+                                         !corridas_por_selecao(plano.memoria), ordem, stats)) {
+        ordenar_1f(arquivo, saida, quantidade, stats, ordem);
+    }
+    marcar_ordenado(saida, ordem);
+    const char *destino = concluir_saida(arquivo_saida, ARQUIVO_SAIDA_1F);
+
+    const char *ordem_str = (ordem == ORDEM_ASCENDENTE) ? "Ascendente" : "Descendente";
+    char nome_algoritmo[100];
+    sprintf(nome_algoritmo, "Intercalacao F+1 - %s (%s)", nome_corridas(plano.memoria), ordem_str);
+    log_metricas(nome_algoritmo, quantidade, situacao == 1 ? "1" : situacao == 2 ? "2" : "3", *stats);
+
+    // Imprime os registros ordenados, se solicitado
+    if (imprime == 1) {
+        printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
+        imprimir_binario(destino);
+    }
+}
@@ -3,93 +3,50 @@
 #include <string.h>
 #include "../include/intercalacao2f.h"
 #include "../include/leitura.h"
-#define MAX_MEMORIA 20 // Tamanho máximo da memória disponível (quantidade máxima de registros na memória principal)
+#include "../include/arvore_perdedores.h"
+#include "../include/ordenacao_interna.h"
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+#ifndef MAX_MEMORIA
+#define MAX_MEMORIA 20 // Memória disponível sem --mem (quantidade máxima de registros na memória principal)
+#endif
 
-// Estrutura para o heap de seleção por substituição
-// Cada nó do heap contém uma nota, a posição original do registro e o ciclo a que pertence
-typedef struct {
-    float nota;          // Nota do registro (valor usado para ordenação)
-    long posicao;        // Posição original no vetor de registros (para recuperar o registro completo depois)
-    int ciclo;           // Número da corrida (ciclo) a que o elemento pertence (usado para separar as corridas)
-} HeapNode;
-
-// Constantes que definem a ordem de ordenação
-#define ORDEM_ASCENDENTE 0  // Para ordenar do menor para o maior
-#define ORDEM_DESCENDENTE 1 // Para ordenar do maior para o menor
-
-// Função auxiliar para comparar duas estruturas NotaPosicao
-// Retorna -1 se a < b, 1 se a > b, e 0 se iguais, considerando a ordem especificada
-int comparar_nota_posicao(const void *a, const void *b, int ordem) {
-    float nota_a = ((NotaPosicao *)a)->nota;
-    float nota_b = ((NotaPosicao *)b)->nota;
-    
-    if (ordem == ORDEM_ASCENDENTE) {
-        // Na ordem ascendente, a < b retorna -1 (a vem antes)
-        if (nota_a < nota_b) return -1;
-        if (nota_a > nota_b) return 1;
-    } else { // ORDEM_DESCENDENTE
-        // Na ordem descendente, a > b retorna -1 (a vem antes)
-        if (nota_a > nota_b) return -1;
-        if (nota_a < nota_b) return 1;
-    }
-    return 0; // Notas iguais
+int ordem_da_situacao(int situacao) {
+    return (situacao == 2) ? ORDEM_DESCENDENTE : ORDEM_ASCENDENTE;
 }
 
 // Funções para manipulação do heap
-// Troca dois nós do heap
-void trocar_nos(HeapNode *a, HeapNode *b) {
-    HeapNode temp = *a;
-    *a = *b;
-    *b = temp;
+// Retorna 1 se o nó 'a' tem prioridade sobre 'b' no heap
+// Primeiro critério: ciclo menor tem prioridade
+// Segundo critério (se mesmo ciclo): menor nota (ascendente) ou maior nota (descendente)
+// Terceiro critério (se mesma nota): menor posição, o que torna a ordem do heap total
+static int prioridade_no(const HeapNode *a, const HeapNode *b, int ordem) {
+    if (a->ciclo != b->ciclo) return a->ciclo < b->ciclo;
+    if (a->nota != b->nota) {
+        return (ordem == ORDEM_ASCENDENTE) ? a->nota < b->nota : a->nota > b->nota;
+    }
+    return a->posicao < b->posicao;
 }
 
 // Função para "descer" um nó no heap, mantendo a propriedade do heap
 // i: índice do nó a ser ajustado, n: tamanho do heap, ordem: ascendente ou descendente
 void descer_no_heap(HeapNode *heap, int i, int n, int ordem) {
-    int escolhido = i;
-    int esquerda = 2 * i + 1; // Índice do filho da esquerda
-    int direita = 2 * i + 2;  // Índice do filho da direita
-    
-    // Comparações baseadas na ordem solicitada
-    if (ordem == ORDEM_ASCENDENTE) {
-        // Compara com o filho da esquerda se existir (procurando o menor)
-        // Primeiro critério: ciclo menor tem prioridade
-        // Segundo critério (se mesmo ciclo): menor nota tem prioridade
-        if (esquerda < n && (heap[esquerda].ciclo < heap[escolhido].ciclo || 
-                          (heap[esquerda].ciclo == heap[escolhido].ciclo && 
-                           heap[esquerda].nota < heap[escolhido].nota))) {
-            escolhido = esquerda;
+    HeapNode no = heap[i];
+    while (1) {
+        int escolhido = 2 * i + 1; // Filho da esquerda
+        if (escolhido >= n) break;
+        // Entre os filhos que existirem, o de maior prioridade
+        if (escolhido + 1 < n && prioridade_no(&heap[escolhido + 1], &heap[escolhido], ordem)) {
+            escolhido++;
         }
-        
-        // Compara com o filho da direita se existir
-        if (direita < n && (heap[direita].ciclo < heap[escolhido].ciclo || 
-                         (heap[direita].ciclo == heap[escolhido].ciclo && 
-                          heap[direita].nota < heap[escolhido].nota))) {
-            escolhido = direita;
-        }
-    } else { // ORDEM_DESCENDENTE
-        // Compara com o filho da esquerda se existir (procurando o maior)
-        // Primeiro critério: ciclo menor tem prioridade
-        // Segundo critério (se mesmo ciclo): maior nota tem prioridade
-        if (esquerda < n && (heap[esquerda].ciclo < heap[escolhido].ciclo || 
-                          (heap[esquerda].ciclo == heap[escolhido].ciclo && 
-                           heap[esquerda].nota > heap[escolhido].nota))) {
-            escolhido = esquerda;
-        }
-        
-        // Compara com o filho da direita se existir
-        if (direita < n && (heap[direita].ciclo < heap[escolhido].ciclo || 
-                         (heap[direita].ciclo == heap[escolhido].ciclo && 
-                          heap[direita].nota > heap[escolhido].nota))) {
-            escolhido = direita;
-        }
-    }
-    
-    // Se o escolhido não for o próprio nó, troca e continua descendo
-    if (escolhido != i) {
-        trocar_nos(&heap[i], &heap[escolhido]);
-        descer_no_heap(heap, escolhido, n, ordem); // Recursivamente continua descendo
+        if (!prioridade_no(&heap[escolhido], &no, ordem)) break;
+        // Sobe o filho e continua descendo a partir dele (sem trocas: o nó é gravado uma vez no fim)
+        heap[i] = heap[escolhido];
+        i = escolhido;
     }
+    heap[i] = no;
 }
 
 // Constrói um heap a partir de um array de nós
@@ -101,450 +58,506 @@ void construir_heap(HeapNode *heap, int n, int ordem) {
     }
 }
 
+// Retorna 1 se a nota 'prox' quebra a ordem em relação à nota 'anterior',
+// ou seja, se 'prox' não pode continuar a mesma corrida
+int quebra_ordem(float anterior, float prox, int ordem) {
+    if (ordem == ORDEM_ASCENDENTE) {
+        return prox < anterior;
+    }
+    return prox > anterior;
+}
+
+// Nó do heap da seleção por substituição. A chave junta o número da corrida (32 bits altos)
+// e a nota codificada na ordem pedida (32 bits baixos): uma única comparação de inteiros
+// ordena pela corrida e depois pela nota, e o fim de uma corrida aparece na própria raiz.
+typedef struct {
+    uint64_t chave;
+    int slot;       // Posição do registro em 'memoria'
+} NoCorrida;        // 16 bytes: 4 nós por linha de cache
+
+#define ARIDADE_HEAP 4
+#define LINHA_CACHE 64
+#define DESLOCAMENTO_HEAP 3 // Nós vazios antes da raiz (ver alocar_heap_corridas)
+
+static uint64_t chave_corrida(int ciclo, float nota, int ordem) {
+    return ((uint64_t)ciclo << 32) | codificar_nota(nota, ordem);
+}
+
+// Aloca o heap 4-ário alinhado à linha de cache (as reservas temporárias já começam em uma
+// linha). A raiz fica DESLOCAMENTO_HEAP nós depois do início do bloco: assim os filhos
+// 4i+1..4i+4 de cada nó ocupam exatamente uma linha, e cada nível da descida custa um único
+// acesso à memória. 'bloco' recebe o ponteiro a liberar.
+static NoCorrida *alocar_heap_corridas(int n, void **bloco) {
+    *bloco = alocar_temporario(((size_t)n + DESLOCAMENTO_HEAP) * sizeof(NoCorrida));
+    return *bloco ? (NoCorrida *)*bloco + DESLOCAMENTO_HEAP : NULL;
+}
+
+// Desce o nó i do heap 4-ário (iterativo, com o nó gravado uma única vez no destino)
+static void descer_no_corrida(NoCorrida *heap, int i, int n, long *comparacoes) {
+    NoCorrida no = heap[i];
+    while (1) {
+        int primeiro = ARIDADE_HEAP * i + 1;
+        if (primeiro >= n) break;
+        int ultimo = (primeiro + ARIDADE_HEAP < n) ? primeiro + ARIDADE_HEAP : n;
+        int menor = primeiro;
+        for (int f = primeiro + 1; f < ultimo; f++) {
+            if (heap[f].chave < heap[menor].chave) menor = f;
+        }
+        *comparacoes += ultimo - primeiro; // Entre os filhos e com o nó que desce
+        if (heap[menor].chave >= no.chave) break;
+        heap[i] = heap[menor];
+        i = menor;
+    }
+    heap[i] = no;
+}
+
 // Função que implementa a seleção por substituição para criar corridas iniciais
-// Divide os registros em corridas ordenadas e distribui nas fitas
-int selecao_por_substituicao(Registro *registros, int quantidade, NotaPosicao *fita1, 
-                             NotaPosicao *fita2, int *tam_fita1, int *tam_fita2, 
-                             Metricas *stats, int ordem) {
-    // Aloca o heap com tamanho MAX_MEMORIA
-    HeapNode *heap = (HeapNode *)malloc(MAX_MEMORIA * sizeof(HeapNode));
-    if (!heap) return 0; // Retorna 0 se falhar a alocação
-    
-    int num_ciclos = 0;       // Contador de corridas geradas
+// Lê a entrada sequencialmente mantendo apenas 'tam_memoria' registros em memória
+// e distribui as corridas alternadamente nas fitas. Cada substituição custa O(log M).
+int selecao_por_substituicao(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                             int tam_memoria, Metricas *stats, int ordem) {
+    // Registros em memória e heap indexado pela posição de cada registro em 'memoria'
+    void *bloco_heap;
+    Registro *memoria = (Registro *)alocar_temporario(tam_memoria * sizeof(Registro));
+    NoCorrida *heap = alocar_heap_corridas(tam_memoria, &bloco_heap);
+    if (!memoria || !heap) {
+        liberar_temporario(bloco_heap);
+        liberar_temporario(memoria);
+        return 0; // Retorna 0 se falhar a alocação
+    }
+
     int heap_size = 0;        // Tamanho atual do heap
-    int prox_registro = 0;    // Próximo registro a ser lido
-    int ciclo_atual = 0;      // Corrida atual
-    *tam_fita1 = 0;           // Inicializa tamanho da fita1
-    *tam_fita2 = 0;           // Inicializa tamanho da fita2
-    
-    clock_t inicio, fim;      // Variáveis para medir tempo
-    iniciar_tempo(&inicio);   // Inicia a contagem de tempo
-    
-    // Inicializar o heap com os primeiros MAX_MEMORIA registros
-    for (int i = 0; i < MAX_MEMORIA && prox_registro < quantidade; i++) {
-        heap[i].nota = registros[prox_registro].nota;
-        heap[i].posicao = prox_registro;
-        heap[i].ciclo = 0;     // Todos começam na corrida 0
-        prox_registro++;
+    int lidos = 0;            // Registros já lidos da entrada
+
+    // Inicializar o heap com os primeiros 'tam_memoria' registros, todos na corrida 0
+    while (heap_size < tam_memoria && lidos < quantidade &&
+           ler_fita(entrada, &memoria[heap_size])) {
+        heap[heap_size].chave = chave_corrida(0, memoria[heap_size].nota, ordem);
+        heap[heap_size].slot = heap_size;
         heap_size++;
-        stats->leituras_pre++; // Incrementa contador de leituras
+        lidos++;
+        stats->leituras_pre++;
     }
-    
-    // Construir o heap inicial
-    construir_heap(heap, heap_size, ordem);
-     
-    // Enquanto houver elementos no heap
+    for (int i = (heap_size - 2) / ARIDADE_HEAP; i >= 0 && heap_size > 1; i--) {
+        descer_no_corrida(heap, i, heap_size, &stats->comparacoes_pre);
+    }
+
+    int num_ciclos = (heap_size > 0) ? 1 : 0; // Contador de corridas geradas
+    uint64_t ciclo_atual = 0; // Corrida atual (já deslocada para os bits altos da chave)
+    int fita = 0;             // Fita que recebe a corrida atual
+    long tamanho_corrida = 0; // Registros gravados na corrida atual
+
     while (heap_size > 0) {
-        // Extrai o menor elementodo heap
-        NotaPosicao saida;
-        saida.nota = heap[0].nota;       // Extrai a nota
-        saida.posicao = heap[0].posicao; // Extrai a posição original
-        
-        // Determinar em qual fita colocar a saída com base na corrida atual
-        // Alterna entre as fitas (fita1 para ciclos pares, fita2 para ciclos ímpares)
-        if (ciclo_atual % 2 == 0) {
-            fita1[(*tam_fita1)++] = saida; // Adiciona à fita1 e incrementa seu tamanho
-        } else {
-            fita2[(*tam_fita2)++] = saida; // Adiciona à fita2 e incrementa seu tamanho
+        // O topo pertence a uma corrida nova: a atual terminou e a próxima vai para a fita seguinte
+        uint64_t ciclo_topo = heap[0].chave & 0xFFFFFFFF00000000ULL;
+        if (ciclo_topo != ciclo_atual) {
+            registrar_tamanho_corrida(stats, tamanho_corrida);
+            tamanho_corrida = 0;
+            ciclo_atual = ciclo_topo;
+            fita = (fita + 1) % num_fitas;
+            num_ciclos++;
         }
-        stats->escritas_pre++; // Incrementa contador de escritas
-        
-        // Se ainda houver registros a serem processados
-        if (prox_registro < quantidade) {
-            // Substitui o elemento removido pelo próximo do input
-            float prox_nota = registros[prox_registro].nota;
-            
-            // Verifica se o próximo registro pode continuar na mesma corrida
-            // Baseado na ordem (ascendente ou descendente)
-            int pode_continuar = 0;
-            if (ordem == ORDEM_ASCENDENTE) {
-                // Em ordem ascendente, o próximo deve ser >= ao atual para continuar
-                pode_continuar = (prox_nota >= saida.nota);
-            } else { // ORDEM_DESCENDENTE
-                // Em ordem descendente, o próximo deve ser <= ao atual para continuar
-                pode_continuar = (prox_nota <= saida.nota);
-            }
-            
-            if (pode_continuar) {
-                // O próximo registro pode continuar na mesma corrida
-                heap[0].nota = prox_nota;
-                heap[0].posicao = prox_registro;
-                heap[0].ciclo = ciclo_atual;
-            } else {
-                // Caso contrário, vai para a próxima corrida
-                heap[0].nota = prox_nota;
-                heap[0].posicao = prox_registro;
-                heap[0].ciclo = ciclo_atual + 1;
-                
-                // Se todos os elementos estão na próxima corrida, avançamos a corrida atual
-                int todos_nova_corrida = 1;
-                for (int i = 1; i < heap_size; i++) {
-                    if (heap[i].ciclo == ciclo_atual) {
-                        todos_nova_corrida = 0;
-                        break;
-                    }
-                }
-                
-                if (todos_nova_corrida) {
-                    ciclo_atual++;    // Avança para a próxima corrida
-                    num_ciclos++;     // Incrementa o contador de corridas
-                }
-            }
-            
-            prox_registro++;          // Avança para o próximo registro de entrada
-            stats->leituras_pre++;    // Incrementa contador de leituras
-            
-            // Restaurar a propriedade do heap após a substituição na raiz
-            descer_no_heap(heap, 0, heap_size, ordem);
-            stats->comparacoes_pre += heap_size * 2; // Aproximação do número de comparações
+
+        // Grava o topo do heap na fita da corrida atual
+        int slot = heap[0].slot;
+        uint64_t ultima = heap[0].chave;
+        escrever_fita(fitas[fita], &memoria[slot]);
+        stats->escritas_pre++;
+        tamanho_corrida++;
+
+        // Substitui o registro que saiu pelo próximo da entrada, no mesmo espaço de memória.
+        // Se a chave nova fica abaixo da que saiu, ela quebra a ordem da corrida atual
+        // e vai para a próxima.
+        if (lidos < quantidade && ler_fita(entrada, &memoria[slot])) {
+            lidos++;
+            stats->leituras_pre++;
+            stats->comparacoes_pre++;
+            uint64_t chave = ciclo_atual | codificar_nota(memoria[slot].nota, ordem);
+            heap[0].chave = (chave < ultima) ? chave + (1ULL << 32) : chave;
         } else {
             // Não há mais registros de entrada, remove-se o elemento do heap
-            heap[0] = heap[heap_size - 1]; // Move o último elemento para a raiz
-            heap_size--;                   // Reduz o tamanho do heap
-            
-            // Se o heap não estiver vazio, restaura a propriedade do heap
-            if (heap_size > 0) {
-                descer_no_heap(heap, 0, heap_size, ordem);
-                stats->comparacoes_pre += heap_size * 2;
-            }
-            
-            // Verifica se todos os elementos restantes são de uma nova corrida
-            int todos_nova_corrida = 1;
-            for (int i = 0; i < heap_size; i++) {
-                if (heap[i].ciclo == ciclo_atual) {
-                    todos_nova_corrida = 0;
-                    break;
-                }
-            }
-            
-            if (todos_nova_corrida && heap_size > 0) {
-                ciclo_atual++;    // Avança para a próxima corrida
-                num_ciclos++;     // Incrementa o contador de corridas
-            }
+            heap[0] = heap[--heap_size];
         }
+
+        // Restaurar a propriedade do heap após a substituição na raiz
+        if (heap_size > 1) descer_no_corrida(heap, 0, heap_size, &stats->comparacoes_pre);
     }
-    
-    // Incrementa num_ciclos para contar a última corrida
-    num_ciclos++;
-    
-    free(heap);  // Libera a memória alocada para o heap
-    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre); // Finaliza medição de tempo
-    
+    if (tamanho_corrida > 0) registrar_tamanho_corrida(stats, tamanho_corrida);
+
+    liberar_temporario(bloco_heap);
+    liberar_temporario(memoria);
+
     return num_ciclos; // Retorna o número total de corridas geradas
 }
 
-// Função para intercalar duas corridas
-// Combina elementos de duas corridas em ordem mantendo a ordenação
-void intercalar_corridas(NotaPosicao *resultado, NotaPosicao *fita1, int *idx1, int fim1, 
-                        NotaPosicao *fita2, int *idx2, int fim2, int *pos_resultado, 
-                        Metricas *stats, int ordem) {
-    // Enquanto houver elementos em ambas as corridas
-    while (*idx1 <= fim1 && *idx2 <= fim2) {
-        stats->comparacoes_pos++; // Incrementa contador de comparações
-        
-        int selecionar_fita1 = 0;
-        if (ordem == ORDEM_ASCENDENTE) {
-            // Em ordem ascendente, seleciona o menor entre os dois
-            selecionar_fita1 = (fita1[*idx1].nota <= fita2[*idx2].nota);
-        } else { // ORDEM_DESCENDENTE
-            // Em ordem descendente, seleciona o maior entre os dois
-            selecionar_fita1 = (fita1[*idx1].nota >= fita2[*idx2].nota);
-        }
-        
-        if (selecionar_fita1) {
-            // Copia o elemento da fita1 para o resultado
-            resultado[(*pos_resultado)++] = fita1[(*idx1)++];
-        } else {
-            // Copia o elemento da fita2 para o resultado
-            resultado[(*pos_resultado)++] = fita2[(*idx2)++];
+// Modo de geração das corridas iniciais (ver definir_modo_corridas)
+static int modo_corridas = CORRIDAS_AUTOMATICO;
+
+void definir_modo_corridas(int modo) {
+    modo_corridas = modo;
+}
+
+// Corridas por radix sobre a entrada mapeada, lendo os registros direto das páginas mapeadas
+static int corridas_por_radix_mapeada(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                                      int tam_memoria, Metricas *stats, int ordem) {
+    ChaveRadix *v = (ChaveRadix *)alocar_temporario(2 * (size_t)tam_memoria * sizeof(ChaveRadix));
+    if (!v) return 0; // Retorna 0 se falhar a alocação
+
+    int lidos = 0;
+    int num_ciclos = 0;
+    while (lidos < quantidade) {
+        int bloco = quantidade - lidos;
+        if (bloco > tam_memoria) bloco = tam_memoria;
+        const Registro *registros = espiar_registros_fita(entrada, bloco, &bloco);
+        if (!registros) break;
+        lidos += bloco;
+        stats->leituras_pre += bloco;
+
+        ordenar_indices_radix(registros, v, bloco, ordem);
+
+        Fita *destino = fitas[num_ciclos % num_fitas];
+        for (int i = 0; i < bloco; i++) {
+            escrever_fita(destino, &registros[v[i].indice]);
         }
-        stats->leituras_pos++; // Incrementa contador de leituras
+        stats->escritas_pre += bloco;
+        registrar_tamanho_corrida(stats, bloco);
+        num_ciclos++;
     }
-    
-    // Copia os elementos restantes da primeira fita, se houver
-    while (*idx1 <= fim1) {
-        resultado[(*pos_resultado)++] = fita1[(*idx1)++];
-        stats->leituras_pos++; // Incrementa contador de leituras
+
+    liberar_temporario(v);
+    return num_ciclos;
+}
+
+// Geração de corridas por blocos: lê 'tam_memoria' registros, ordena o bloco inteiro em
+// tempo linear com radix e grava-o como uma corrida, alternando as fitas
+int corridas_por_radix(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                       int tam_memoria, Metricas *stats, int ordem) {
+    if (entrada->mapa) {
+        return corridas_por_radix_mapeada(entrada, quantidade, fitas, num_fitas, tam_memoria, stats, ordem);
     }
-    
-    // Copia os elementos restantes da segunda fita, se houver
-    while (*idx2 <= fim2) {
-        resultado[(*pos_resultado)++] = fita2[(*idx2)++];
-        stats->leituras_pos++; // Incrementa contador de leituras
+
+    Registro *memoria = (Registro *)alocar_temporario(tam_memoria * sizeof(Registro));
+    if (!memoria) return 0; // Retorna 0 se falhar a alocação
+
+    int lidos = 0;
+    int num_ciclos = 0;
+    while (lidos < quantidade) {
+        int bloco = quantidade - lidos;
+        if (bloco > tam_memoria) bloco = tam_memoria;
+        bloco = ler_registros_fita(entrada, memoria, bloco);
+        if (bloco <= 0) break;
+        lidos += bloco;
+        stats->leituras_pre += bloco;
+
+        ordenar_registros_radix(memoria, bloco, ordem);
+
+        escrever_registros_fita(fitas[num_ciclos % num_fitas], memoria, bloco);
+        stats->escritas_pre += bloco;
+        registrar_tamanho_corrida(stats, bloco);
+        num_ciclos++;
     }
+
+    liberar_temporario(memoria);
+    return num_ciclos;
 }
 
-// Função principal de intercalação balanceada com seleção por substituição
-// Implementa o algoritmo completo de ordenação externa
-void intercalacao_balanceada_2f(const char *nome_arquivo, int quantidade, int situacao, 
-                                Metricas *stats, int ordem, int imprime) {
-    Registro *registros = NULL;
-    clock_t inicio, fim;
-    iniciar_tempo(&inicio); // Inicia a contagem de tempo
-    
-    // Lê os registros do arquivo binário
-    ler_binario("./data/registros.bin", &registros, quantidade);
-    if (!registros) {
-        printf("Erro ao ler registros.\n");
-        return;
+int corridas_por_selecao(int tam_memoria) {
+    return !((modo_corridas == CORRIDAS_RADIX) ||
+             (modo_corridas == CORRIDAS_AUTOMATICO && tam_memoria >= LIMIAR_RADIX_CORRIDAS));
+}
+
+const char *nome_corridas(int tam_memoria) {
+    return corridas_por_selecao(tam_memoria) ? "Selecao Substituicao" : "Radix por Blocos";
+}
+
+// Gera as corridas iniciais com o método configurado. No modo automático, a ordenação
+// radix por blocos substitui a seleção por substituição quando a memória comporta blocos grandes
+int gerar_corridas(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                   int tam_memoria, Metricas *stats, int ordem) {
+    if (!corridas_por_selecao(tam_memoria)) {
+        return corridas_por_radix(entrada, quantidade, fitas, num_fitas, tam_memoria, stats, ordem);
+    }
+    return selecao_por_substituicao(entrada, quantidade, fitas, num_fitas, tam_memoria, stats, ordem);
+}
+
+// Lê o próximo registro de uma fita, atualizando seu estado
+void avancar_fita(EstadoFita *f, Metricas *stats) {
+    f->tem_registro = ler_fita(f->fita, &f->atual);
+    if (f->tem_registro) {
+        stats->leituras_pos++;
     }
-    
-    // Aloca memória para as "fitas" (arrays que simulam fitas magnéticas)
-    NotaPosicao *fita1 = malloc(quantidade * sizeof(NotaPosicao));
-    NotaPosicao *fita2 = malloc(quantidade * sizeof(NotaPosicao));
-    NotaPosicao *resultado = malloc(quantidade * sizeof(NotaPosicao));
-    int tam_fita1, tam_fita2;
-    
-    // Verifica se as alocações foram bem-sucedidas
-    if (!fita1 || !fita2 || !resultado) {
+}
+
+// Função para intercalar uma corrida de cada fita ativa na fita de saída
+// A seleção usa uma árvore de perdedores com uma folha por fita (k-way);
+// a corrida de uma fita termina no fim do arquivo, depois de 'restantes' registros ou,
+// se o tamanho não é conhecido, numa quebra de ordem. Retorna os registros gravados.
+long intercalar_corridas(EstadoFita *fitas, int num_fitas, Fita *saida, ArvorePerdedores *arv,
+                         Metricas *stats, int ordem) {
+    for (int i = 0; i < num_fitas; i++) {
+        fitas[i].ativa = fitas[i].tem_registro && fitas[i].restantes != 0;
+        arv->chaves[i] = fitas[i].atual.nota;
+        arv->ativa[i] = fitas[i].ativa;
+    }
+    construir_arvore_perdedores(arv);
+
+    long gravados = 0;
+    int escolhida;
+    while ((escolhida = vencedora_arvore_perdedores(arv)) >= 0) {
+        // Copia o registro vencedor para a saída e avança a fita correspondente
+        EstadoFita *f = &fitas[escolhida];
+        escrever_fita(saida, &f->atual);
+        stats->escritas_pos++;
+        gravados++;
+
+        float ultima = f->atual.nota;
+        avancar_fita(f, stats);
+        if (!f->tem_registro) {
+            f->ativa = 0;
+        } else if (f->restantes > 0) {
+            f->ativa = (--f->restantes > 0);
+        } else {
+            stats->comparacoes_pos++;
+            f->ativa = !quebra_ordem(ultima, f->atual.nota, ordem);
+        }
+        atualizar_arvore_perdedores(arv, escolhida, f->atual.nota, f->ativa);
+    }
+    return gravados;
+}
+
+// Realiza uma passada de intercalação: enquanto houver registros nas fitas de entrada,
+// intercala uma corrida de cada uma e grava o resultado alternadamente nas fitas de saída.
+// Se 'tamanhos' não é NULL, traz o tamanho de cada corrida de entrada, na ordem em que foram
+// distribuídas (a corrida r está na fita r % num_entradas), e recebe o das corridas gravadas:
+// as corridas terminam pelo tamanho, e não numa quebra de ordem, então duas corridas seguidas
+// da mesma fita nunca se fundem e um empate sempre favorece a corrida anterior da entrada.
+// Retorna o número de corridas gravadas.
+int intercalar_fitas(Fita **entradas, int num_entradas, Fita **saidas, int num_saidas,
+                     long *tamanhos, Metricas *stats, int ordem) {
+    EstadoFita *fitas = (EstadoFita *)alocar_temporario(num_entradas * sizeof(EstadoFita));
+    ArvorePerdedores *arv = criar_arvore_perdedores(num_entradas, ordem, &stats->comparacoes_pos);
+    if (!fitas || !arv) {
         printf("Erro ao alocar memória para fitas.\n");
-        free(registros);
-        if (fita1) free(fita1);
-        if (fita2) free(fita2);
-        if (resultado) free(resultado);
-        return;
+        liberar_arvore_perdedores(arv);
+        liberar_temporario(fitas);
+        return 0;
     }
-    
-    // Gera as corridas iniciais usando seleção por substituição
-    int num_ciclos = selecao_por_substituicao(registros, quantidade, fita1, fita2, 
-                                             &tam_fita1, &tam_fita2, stats, ordem);
-    
-    // Aloca vetor para armazenar posições ordenadas (resultado final)
-    long *posicoes_ordenadas = malloc(quantidade * sizeof(long));
-    if (!posicoes_ordenadas) {
-        printf("Erro ao alocar memória para posições ordenadas.\n");
-        free(registros);
-        free(fita1);
-        free(fita2);
-        free(resultado);
-        return;
+
+    for (int i = 0; i < num_entradas; i++) {
+        fitas[i].fita = entradas[i];
+        fitas[i].ativa = 0;
+        fitas[i].restantes = -1;
+        avancar_fita(&fitas[i], stats);
     }
-    
-    // Inicia a fase de intercalação
-    iniciar_tempo(&inicio);
-    
-    // Se apenas uma corrida foi gerada, o resultado já está ordenado
-    if (num_ciclos <= 1) {
-        if (tam_fita1 > 0) {
-            // A corrida está na fita1, copia as posições
-            for (int i = 0; i < tam_fita1; i++) {
-                posicoes_ordenadas[i] = fita1[i].posicao;
-                stats->leituras_pos++;
-            }
-        } else if (tam_fita2 > 0) {
-            // A corrida está na fita2, copia as posições
-            for (int i = 0; i < tam_fita2; i++) {
-                posicoes_ordenadas[i] = fita2[i].posicao;
-                stats->leituras_pos++;
-            }
+
+    int corridas = 0;
+    while (1) {
+        int restantes = 0;
+        for (int i = 0; i < num_entradas; i++) {
+            restantes += fitas[i].tem_registro;
         }
-    } else {
-        // Múltiplas corridas - necessário intercalá-las
-        // Cria arrays para rastrear informações de corridas explicitamente
-        int *ciclos_fita1 = malloc((num_ciclos + 1) * sizeof(int));
-        int *ciclos_fita2 = malloc((num_ciclos + 1) * sizeof(int));
-        int num_ciclos_fita1 = 0;
-        int num_ciclos_fita2 = 0;
-        
-        // Inicializa os limites das corridas - distribui corridas uniformemente
-        for (int i = 0; i < num_ciclos; i++) {
-            if (i % 2 == 0 && tam_fita1 > 0) {
-                // Corridas pares vão para a fita1
-                if (num_ciclos_fita1 == 0) {
-                    ciclos_fita1[num_ciclos_fita1++] = 0; // Início da primeira corrida
-                }
-                
-                // Encontra o fim desta corrida verificando quebras de ordem
-                int ciclo_fim = tam_fita1 - 1;
-                for (int j = ciclos_fita1[num_ciclos_fita1-1]; j < tam_fita1 - 1; j++) {
-                    // Quebra de ordem dependendo da ordem ascendente/descendente
-                    if ((ordem == ORDEM_ASCENDENTE && fita1[j].nota > fita1[j+1].nota) ||
-                        (ordem == ORDEM_DESCENDENTE && fita1[j].nota < fita1[j+1].nota)) {
-                        ciclo_fim = j;
-                        break;
-                    }
-                }
-                ciclos_fita1[num_ciclos_fita1++] = ciclo_fim + 1; // Início da próxima corrida
-            } else if (tam_fita2 > 0) {
-                // Corridas ímpares vão para a fita2
-                if (num_ciclos_fita2 == 0) {
-                    ciclos_fita2[num_ciclos_fita2++] = 0; // Início da primeira corrida
-                }
-                
-                // Encontra o fim desta corrida
-                int ciclo_fim = tam_fita2 - 1;
-                for (int j = ciclos_fita2[num_ciclos_fita2-1]; j < tam_fita2 - 1; j++) {
-                    // Quebra de ordem dependendo da ordem ascendente/descendente
-                    if ((ordem == ORDEM_ASCENDENTE && fita2[j].nota > fita2[j+1].nota) ||
-                        (ordem == ORDEM_DESCENDENTE && fita2[j].nota < fita2[j+1].nota)) {
-                        ciclo_fim = j;
-                        break;
-                    }
-                }
-                ciclos_fita2[num_ciclos_fita2++] = ciclo_fim + 1; // Início da próxima corrida
-            }
+        if (restantes == 0) {
+            break;
         }
-        
-        // Corrige os limites da última corrida
-        if (num_ciclos_fita1 > 0) {
-            ciclos_fita1[num_ciclos_fita1] = tam_fita1;
+
+        if (tamanhos) {
+            // Cada fita com registros ainda tem a sua corrida deste ciclo
+            for (int i = 0; i < num_entradas; i++) {
+                fitas[i].restantes = fitas[i].tem_registro ? tamanhos[(long)corridas * num_entradas + i] : 0;
+            }
         }
-        if (num_ciclos_fita2 > 0) {
-            ciclos_fita2[num_ciclos_fita2] = tam_fita2;
+        long gravados = intercalar_corridas(fitas, num_entradas, saidas[corridas % num_saidas], arv, stats, ordem);
+        if (tamanhos) tamanhos[corridas] = gravados;
+        corridas++;
+    }
+
+    liberar_arvore_perdedores(arv);
+    liberar_temporario(fitas);
+    return corridas;
+}
+
+// Abre num_fitas fitas sobre os arquivos temporários indicados, no modo pedido
+static void abrir_fitas_2f(Fita **fitas, const int *arquivos, int num_fitas, int modo, long *contador_blocos) {
+    for (int i = 0; i < num_fitas; i++) {
+        fitas[i] = abrir_fita_temporaria(arquivos[i], modo, contador_blocos);
+    }
+}
+
+// Fecha um grupo de num_fitas fitas
+static void fechar_fitas_2f(Fita **fitas, int num_fitas) {
+    for (int i = 0; i < num_fitas; i++) {
+        fechar_fita(fitas[i]);
+        fitas[i] = NULL;
+    }
+}
+
+// Distribui as corridas naturais da entrada (trechos já em ordem) alternadamente nas fitas,
+// sem ordenação em memória, e anota o tamanho de cada uma em 'tamanhos'. Retorna o número
+// de corridas distribuídas.
+int distribuir_corridas_naturais(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                                 long *tamanhos, Metricas *stats, int ordem) {
+    Registro reg;
+    int lidos = 0;
+    int corridas = 0;
+    float anterior = 0.0f;
+    while (lidos < quantidade && ler_fita(entrada, &reg)) {
+        if (lidos == 0) {
+            corridas = 1;
+        } else {
+            stats->comparacoes_pre++;
+            if (quebra_ordem(anterior, reg.nota, ordem)) corridas++;
         }
-        
-        // Intercala até que reste apenas uma corrida
-        while (num_ciclos_fita1 + num_ciclos_fita2 > 1) {
-            int pos_resultado = 0;
-            int next_fita1 = 0;
-            int next_fita2 = 0;
-            
-            // Intercala pares de corridas
-            while (next_fita1 < num_ciclos_fita1 && next_fita2 < num_ciclos_fita2) {
-                // Obtém os limites das corridas
-                int inicio_fita1 = ciclos_fita1[next_fita1];
-                int fim_fita1 = ciclos_fita1[next_fita1 + 1] - 1;
-                int inicio_fita2 = ciclos_fita2[next_fita2];
-                int fim_fita2 = ciclos_fita2[next_fita2 + 1] - 1;
-                
-                // Intercala estas duas corridas
-                int idx1 = inicio_fita1;
-                int idx2 = inicio_fita2;
-                intercalar_corridas(resultado, fita1, &idx1, fim_fita1, 
-                                   fita2, &idx2, fim_fita2, 
-                                   &pos_resultado, stats, ordem);
-                
-                next_fita1++;
-                next_fita2++;
-            }
-            
-            // Trata corridas remanescentes da fita1
-            while (next_fita1 < num_ciclos_fita1) {
-                int inicio = ciclos_fita1[next_fita1];
-                int fim = ciclos_fita1[next_fita1 + 1] - 1;
-                
-                // Copia a corrida diretamente para o resultado
-                for (int i = inicio; i <= fim; i++) {
-                    resultado[pos_resultado++] = fita1[i];
-                    stats->leituras_pos++;
-                    stats->escritas_pos++;
-                }
-                
-                next_fita1++;
-            }
-            
-            // Trata corridas remanescentes da fita2
-            while (next_fita2 < num_ciclos_fita2) {
-                int inicio = ciclos_fita2[next_fita2];
-                int fim = ciclos_fita2[next_fita2 + 1] - 1;
-                
-                // Copia a corrida diretamente para o resultado
-                for (int i = inicio; i <= fim; i++) {
-                    resultado[pos_resultado++] = fita2[i];
-                    stats->leituras_pos++;
-                    stats->escritas_pos++;
-                }
-                
-                next_fita2++;
-            }
-            
-            // Prepara para a próxima iteração - distribui corridas de volta para as fitas
-            tam_fita1 = 0;
-            tam_fita2 = 0;
-            num_ciclos_fita1 = 0;
-            num_ciclos_fita2 = 0;
-            
-            // Reinicia os rastreadores de corridas
-            ciclos_fita1[0] = 0;
-            ciclos_fita2[0] = 0;
-            
-            // Vasculha o resultado para encontrar corridas e distribuí-las
-            int ciclo_start = 0;
-            for (int i = 1; i < pos_resultado; i++) {
-                // Detecta quando ocorre uma quebra na ordem
-                if ((ordem == ORDEM_ASCENDENTE && resultado[i-1].nota > resultado[i].nota) ||
-                    (ordem == ORDEM_DESCENDENTE && resultado[i-1].nota < resultado[i].nota)) {
-                    // Fim de uma corrida detectada
-                    if (num_ciclos_fita1 <= num_ciclos_fita2) {
-                        // Copia para a fita1 (balanceamento)
-                        for (int j = ciclo_start; j < i; j++) {
-                            fita1[tam_fita1++] = resultado[j];
-                        }
-                        ciclos_fita1[num_ciclos_fita1 + 1] = tam_fita1;
-                        num_ciclos_fita1++;
-                    } else {
-                        // Copia para a fita2 (balanceamento)
-                        for (int j = ciclo_start; j < i; j++) {
-                            fita2[tam_fita2++] = resultado[j];
-                        }
-                        ciclos_fita2[num_ciclos_fita2 + 1] = tam_fita2;
-                        num_ciclos_fita2++;
-                    }
-                    ciclo_start = i;
-                }
-            }
-            
-            // Trata a última corrida
-            if (ciclo_start < pos_resultado) {
-                if (num_ciclos_fita1 <= num_ciclos_fita2) {
-                    // Copia para a fita1
-                    for (int j = ciclo_start; j < pos_resultado; j++) {
-                        fita1[tam_fita1++] = resultado[j];
-                    }
-                    ciclos_fita1[num_ciclos_fita1 + 1] = tam_fita1;
-                    num_ciclos_fita1++;
-                } else {
-                    // Copia para a fita2
-                    for (int j = ciclo_start; j < pos_resultado; j++) {
-                        fita2[tam_fita2++] = resultado[j];
-                    }
-                    ciclos_fita2[num_ciclos_fita2 + 1] = tam_fita2;
-                    num_ciclos_fita2++;
-                }
-            }
+        escrever_fita(fitas[(corridas - 1) % num_fitas], &reg);
+        tamanhos[corridas - 1]++;
+        anterior = reg.nota;
+        lidos++;
+    }
+    stats->leituras_pre += lidos;
+    stats->escritas_pre += lidos;
+    return corridas;
+}
+
+// Plano de memória da intercalação 2F: a área de trabalho guarda registros e seus pares de
+// ordenação (heap ou radix) ao lado da entrada e de uma fita de corridas por via; na
+// intercalação, cada via tem uma fita de entrada, uma de saída, seu estado e sua folha na árvore
+static void planejar_2f(int quantidade, PlanoMemoria *plano, Metricas *stats) {
+    RequisitosMemoria req = {MAX_MEMORIA, sizeof(Registro) + 2 * sizeof(ChaveRadix), 0, 1, 1, 2,
+                             sizeof(EstadoFita) + BYTES_FOLHA_ARVORE, FAN_IN_MAXIMO};
+    planejar_memoria(&req, quantidade, plano, stats);
+}
+
+// Ordenação externa completa com 2F fitas em disco, deixando o resultado em 'destino':
+// as corridas são intercaladas F a F, alternando o papel de entrada e saída dos dois grupos.
+// Se corridas_naturais > 0, a entrada já é formada por esse número de corridas naturais,
+// que são apenas distribuídas; caso contrário, as corridas são geradas em memória.
+// F é escolhido em tempo de execução a partir do plano de memória (sem --mem, MAX_MEMORIA:
+// um registro por fita na intercalação)
+static void ordenar_2f(const char *nome_arquivo, const char *destino, int quantidade,
+                       long corridas_naturais, Metricas *stats, int ordem) {
+    Fita *entradas[FAN_IN_MAXIMO];
+    Fita *saidas[FAN_IN_MAXIMO];
+    int arquivos[2 * FAN_IN_MAXIMO]; // Arquivos temporários das 2F fitas
+    Cronometro inicio, fim;
+
+    PlanoMemoria plano;
+    planejar_2f(quantidade, &plano, stats);
+    int tam_memoria = plano.memoria;
+
+    // Estimativa pessimista do número de corridas: uma por memória cheia
+    long corridas_estimadas = (corridas_naturais > 0) ? corridas_naturais : (quantidade + tam_memoria - 1) / tam_memoria;
+    int num_fitas = calcular_fan_in(plano.fan_in, corridas_estimadas);
+    for (int i = 0; i < 2 * num_fitas; i++) arquivos[i] = reservar_arquivo_temporario();
+
+    // Tamanhos das corridas naturais: as passadas terminam cada corrida pelo tamanho, o que
+    // mantém a intercalação estável mesmo quando duas corridas da mesma fita se emendam em ordem
+    long *tamanhos = NULL;
+    if (corridas_naturais > 0) {
+        tamanhos = (long *)alocar_temporario(corridas_naturais * sizeof(long));
+        if (!tamanhos) {
+            perror("Erro ao alocar memória para os tamanhos das corridas");
+            exit(EXIT_FAILURE);
         }
-        
-        // O resultado final está em uma das fitas
-        if (num_ciclos_fita1 == 1) {
-            // Se a fita1 tem uma corrida, ela contém o resultado final
-            for (int i = 0; i < tam_fita1; i++) {
-                posicoes_ordenadas[i] = fita1[i].posicao;
-            }
-        } else if (num_ciclos_fita2 == 1) {
-            // Se a fita2 tem uma corrida, ela contém o resultado final
-            for (int i = 0; i < tam_fita2; i++) {
-                posicoes_ordenadas[i] = fita2[i].posicao;
+        memset(tamanhos, 0, corridas_naturais * sizeof(long));
+    }
+
+    // Cada fase devolve à arena o que reservou (heap, buffers das fitas, árvore de perdedores)
+    long marca = marcar_arena();
+
+    // Gera (ou distribui) as corridas iniciais no primeiro grupo de fitas
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "corridas");
+    Fita *entrada = abrir_fita_entrada(nome_arquivo, &stats->blocos_lidos_pre);
+    abrir_fitas_2f(entradas, arquivos, num_fitas, FITA_ESCRITA, &stats->blocos_escritos_pre);
+    int num_ciclos;
+    if (corridas_naturais > 0) {
+        num_ciclos = distribuir_corridas_naturais(entrada, quantidade, entradas, num_fitas, tamanhos, stats, ordem);
+    } else {
+        num_ciclos = gerar_corridas(entrada, quantidade, entradas, num_fitas, tam_memoria, stats, ordem);
+    }
+    fechar_fita(entrada);
+    fechar_fitas_2f(entradas, num_fitas);
+    restaurar_arena(marca);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+    // Inicia a fase de intercalação
+    iniciar_tempo(&inicio);
+    int grupo_entrada = 0; // 0: fitas [0, F) são a entrada; F: fitas [F, 2F)
+    int fita_resultado = 0;
+
+    // Se apenas uma corrida foi gerada, o resultado já está ordenado na primeira fita
+    if (num_ciclos > 1) {
+        for (int passada = 1; ; passada++) {
+            char nome_fase[TAM_NOME_FASE];
+            snprintf(nome_fase, sizeof(nome_fase), "passada %d", passada);
+            iniciar_fase(stats, nome_fase);
+            int grupo_saida = num_fitas - grupo_entrada;
+            abrir_fitas_2f(entradas, arquivos + grupo_entrada, num_fitas, FITA_LEITURA, &stats->blocos_lidos_pos);
+            abrir_fitas_2f(saidas, arquivos + grupo_saida, num_fitas, FITA_ESCRITA, &stats->blocos_escritos_pos);
+            int corridas = intercalar_fitas(entradas, num_fitas, saidas, num_fitas, tamanhos, stats, ordem);
+            fechar_fitas_2f(entradas, num_fitas);
+            fechar_fitas_2f(saidas, num_fitas);
+            restaurar_arena(marca);
+
+            // As fitas de saída passam a ser as de entrada da próxima passada
+            grupo_entrada = grupo_saida;
+            if (corridas <= 1) {
+                fita_resultado = grupo_saida;
+                break;
             }
         }
-        
-        // Libera a memória alocada para os arrays de corridas
-        free(ciclos_fita1);
-        free(ciclos_fita2);
     }
-    
+
     // Finaliza a medição do tempo de execução
+    finalizar_fase(stats);
     finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
-    
+
+    // A fita com a corrida final vira o arquivo de saída; as demais são devolvidas
+    exportar_arquivo_temporario(arquivos[fita_resultado], destino);
+    for (int i = 0; i < 2 * num_fitas; i++) {
+        if (i != fita_resultado) devolver_arquivo_temporario(arquivos[i]);
+    }
+    liberar_temporario(tamanhos);
+}
+
+// Intercalação natural: aproveita as corridas já existentes na entrada
+void intercalacao_natural(const char *nome_arquivo, const char *destino, int quantidade,
+                          long corridas, Metricas *stats, int ordem) {
+    ordenar_2f(nome_arquivo, destino, quantidade, corridas, stats, ordem);
+}
+
+// Função principal de intercalação balanceada com seleção por substituição
+void intercalacao_balanceada_2f(const char *nome_arquivo, int quantidade, int situacao,
+                                Metricas *stats, int ordem, int imprime) {
+    Cronometro inicio, fim;
+    PlanoMemoria plano;
+    planejar_2f(quantidade, &plano, stats);
+
+    // A saída é preparada em um temporário e só vai para o destino no fim
+    char saida[TAM_CAMINHO_TEMPORARIO];
+    int arquivo_saida = preparar_saida(saida);
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): basta copiá-la
+    iniciar_tempo(&inicio);
+    if (copiar_se_ordenado(nome_arquivo, saida, quantidade, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else if (!ordenar_adaptativo(nome_arquivo, saida, quantidade, plano.memoria,
+                                         !corridas_por_selecao(plano.memoria), ordem, stats)) {
+        ordenar_2f(nome_arquivo, saida, quantidade, 0, stats, ordem);
+    }
+    marcar_ordenado(saida, ordem);
+    const char *destino = concluir_saida(arquivo_saida, ARQUIVO_SAIDA_2F);
+
     // Registra as métricas de desempenho
     const char* ordem_str = (ordem == ORDEM_ASCENDENTE) ? "Ascendente" : "Descendente";
     char nome_algoritmo[100];
-    sprintf(nome_algoritmo, "Intercalacao 2f - Selecao Substituicao (%s)", ordem_str);
+    sprintf(nome_algoritmo, "Intercalacao 2f - %s (%s)", nome_corridas(plano.memoria), ordem_str);
     log_metricas(nome_algoritmo, quantidade, situacao == 1 ? "1" : situacao == 2 ? "2" : "3", *stats);
-    
+
     // Imprime os registros ordenados, se solicitado
     if (imprime == 1) {
-      printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
-      for (int i = 0; i < quantidade; i++) {
-          print_registro(&registros[posicoes_ordenadas[i]]);
-      } 
+        printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
+        imprimir_binario(destino);
     }
-
-    // Libera a memória alocada
-    free(posicoes_ordenadas);
-    free(fita1);
-    free(fita2);
-    free(resultado);
-    free(registros);
 }
 
 // Wrapper para a versão ascendente (compatibilidade com código existente)
@@ -557,4 +570,4 @@ void intercalacao_balanceada_2f_ascendente(const char *nome_arquivo, int quantid
 // Chama a função genérica com parâmetro ORDEM_DESCENDENTE
 void intercalacao_balanceada_2f_descendente(const char *nome_arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
     intercalacao_balanceada_2f(nome_arquivo, quantidade, situacao, stats, ORDEM_DESCENDENTE, imprime);
-}
\ No newline at end of file
+}
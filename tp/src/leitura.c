@@ -1,8 +1,19 @@
 #include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/intercalacao2f.h"
+#include "../include/arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h> // Para a função isspace
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Mapeamento mantido durante todo o processo (ver mapear_binario)
+static ArquivoMapeado mapeamento = {NULL, 0, 0, 0, ""};
 
 // Função para remover espaços em branco no início e no final de uma string
 void trim_string(char *str) {
@@ -29,30 +40,272 @@ void trim_string(char *str) {
     str[i] = '\0';
 }
 
-// Função para ler registros de um arquivo binário
-void ler_binario(const char *nome_binario, Registro **registros, int quantidade) {
-    FILE *arquivo = abrir_arquivo(nome_binario, "rb");
-    if (!arquivo) {
+// Função para imprimir todos os registros de um arquivo binário
+// Os registros são lidos em blocos e formatados em um buffer com as linhas de um bloco (até
+// TAM_BUFFER_IMPRESSAO bytes), gravado na saída padrão com uma única chamada
+void imprimir_binario(const char *nome_binario) {
+    Fita *arquivo = abrir_fita(nome_binario, FITA_LEITURA, NULL);
+    int capacidade = registros_por_bloco();
+    long tam_buffer = (long)capacidade * TAM_LINHA_REGISTRO;
+    if (tam_buffer > TAM_BUFFER_IMPRESSAO) tam_buffer = TAM_BUFFER_IMPRESSAO;
+    Registro *bloco = (Registro *)alocar_temporario(capacidade * sizeof(Registro));
+    char *buffer = (char *)alocar_temporario(tam_buffer);
+    if (!bloco || !buffer) {
+        perror("Erro ao alocar memória para a impressão");
+        exit(EXIT_FAILURE);
+    }
+
+    fflush(stdout);
+    size_t usado = 0;
+    int n;
+    while ((n = ler_registros_fita(arquivo, bloco, capacidade)) > 0) {
+        for (int i = 0; i < n; i++) {
+            if (usado + TAM_LINHA_REGISTRO > (size_t)tam_buffer) {
+                fwrite(buffer, 1, usado, stdout);
+                usado = 0;
+            }
+            usado += formatar_registro(&bloco[i], buffer + usado);
+        }
+    }
+    fwrite(buffer, 1, usado, stdout);
+    fflush(stdout);
+
+    liberar_temporario(buffer);
+    liberar_temporario(bloco);
+    fechar_fita(arquivo);
+}
+
+// Função para mapear um arquivo binário de registros em memória
+const ArquivoMapeado *mapear_binario(const char *nome_binario) {
+    if (mapeamento.nome[0] != '\0' && strcmp(mapeamento.nome, nome_binario) == 0) {
+        return &mapeamento;
+    }
+    desmapear_binario();
+
+    int fd = open(nome_binario, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
         perror("Erro ao abrir o arquivo binário");
         exit(EXIT_FAILURE);
     }
 
-    // Aloca memória para o vetor de registros
-    *registros = (Registro*)malloc(quantidade * sizeof(Registro));
-    if (!(*registros)) {
-        perror("Erro ao alocar memória");
-        fechar_arquivo(arquivo);
+    CabecalhoArquivo c;
+    mapeamento.inicio = ler_cabecalho(fd, &c) ? c.tam_cabecalho : 0;
+    mapeamento.quantidade = (st.st_size - (long)mapeamento.inicio) / sizeof(Registro);
+    mapeamento.tamanho = mapeamento.inicio + mapeamento.quantidade * sizeof(Registro);
+    if (mapeamento.quantidade > 0) {
+        void *base = mmap(NULL, mapeamento.tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            perror("Erro ao mapear o arquivo binário");
+            exit(EXIT_FAILURE);
+        }
+        // O arquivo é percorrido do início ao fim: leitura antecipada agressiva
+        madvise(base, mapeamento.tamanho, MADV_SEQUENTIAL);
+        madvise(base, mapeamento.tamanho, MADV_WILLNEED);
+        mapeamento.registros = (const Registro *)((const char *)base + mapeamento.inicio);
+    }
+    close(fd); // O mapeamento continua válido após o fechamento do descritor
+
+    strncpy(mapeamento.nome, nome_binario, sizeof(mapeamento.nome) - 1);
+    mapeamento.nome[sizeof(mapeamento.nome) - 1] = '\0';
+    return &mapeamento;
+}
+
+// Função para desfazer o mapeamento do arquivo binário
+void desmapear_binario(void) {
+    if (mapeamento.registros) {
+        munmap((char *)mapeamento.registros - mapeamento.inicio, mapeamento.tamanho);
+    }
+    mapeamento.registros = NULL;
+    mapeamento.quantidade = 0;
+    mapeamento.tamanho = 0;
+    mapeamento.inicio = 0;
+    mapeamento.nome[0] = '\0';
+}
+
+// Bytes de um registro cobertos pela soma de verificação (todos os campos, sem o preenchimento final)
+#define BYTES_SOMA (offsetof(Registro, curso) + TAM_CURSO)
+
+// Função para calcular a soma de verificação de um vetor de registros
+uint64_t soma_registros(const Registro *v, long n) {
+    uint64_t soma = 0;
+    for (long i = 0; i < n; i++) {
+        const unsigned char *p = (const unsigned char *)&v[i];
+        uint64_t h = 0xcbf29ce484222325ULL;
+        size_t k = 0;
+        // Mistura 8 bytes por vez e os bytes restantes um a um
+        for (; k + 8 <= BYTES_SOMA; k += 8) {
+            uint64_t palavra;
+            memcpy(&palavra, p + k, 8);
+            h = (h ^ palavra) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 29;
+        }
+        for (; k < BYTES_SOMA; k++) {
+            h = (h ^ p[k]) * 0x100000001b3ULL;
+        }
+        h ^= h >> 32;
+        soma += h;
+    }
+    return soma;
+}
+
+void iniciar_cabecalho(CabecalhoArquivo *c) {
+    memset(c, 0, sizeof(CabecalhoArquivo));
+    memcpy(c->magica, CABECALHO_MAGICA, sizeof(c->magica));
+    c->versao = CABECALHO_VERSAO;
+    c->tam_cabecalho = (uint32_t)TAM_CABECALHO;
+    c->tam_registro = (uint32_t)sizeof(Registro);
+    c->deslocamento_chave = (uint32_t)offsetof(Registro, nota);
+    c->chave = CHAVE_NENHUMA;
+    c->ordem = ORDEM_ASCENDENTE;
+}
+
+// Função para ler o cabeçalho de um arquivo binário aberto
+int ler_cabecalho(int fd, CabecalhoArquivo *c) {
+    if (pread(fd, c, sizeof(CabecalhoArquivo), 0) != (ssize_t)sizeof(CabecalhoArquivo) ||
+        memcmp(c->magica, CABECALHO_MAGICA, sizeof(c->magica)) != 0) {
+        return 0; // Arquivo legado: os registros começam no primeiro byte
+    }
+    if (c->versao > CABECALHO_VERSAO || c->tam_registro != sizeof(Registro) ||
+        c->deslocamento_chave != offsetof(Registro, nota) || c->tam_cabecalho < sizeof(CabecalhoArquivo)) {
+        printf("Arquivo binário incompatível (versão %u, registro de %u bytes).\n", c->versao, c->tam_registro);
         exit(EXIT_FAILURE);
     }
-    memset(*registros, 0, quantidade * sizeof(Registro));
+    return 1;
+}
+
+// Função para gravar o cabeçalho no início de um arquivo binário aberto; retorna 0 na falha
+int gravar_cabecalho(int fd, const CabecalhoArquivo *c) {
+    char bloco[TAM_CABECALHO];
+    memset(bloco, 0, sizeof(bloco));
+    memcpy(bloco, c, sizeof(CabecalhoArquivo));
+    return pwrite(fd, bloco, sizeof(bloco), 0) == (ssize_t)sizeof(bloco);
+}
 
-    // Lê os registros do arquivo binário
-    int i = 0;
-    while (i < quantidade && fread(&((*registros)[i]), sizeof(Registro), 1, arquivo) == 1) {
-        i++;
+void escrever_cabecalho(int fd, const CabecalhoArquivo *c) {
+    if (!gravar_cabecalho(fd, c)) {
+        perror("Erro ao gravar o cabeçalho");
+        exit(EXIT_FAILURE);
     }
+}
 
-    fechar_arquivo(arquivo);
+int consultar_binario(const char *nome_binario, CabecalhoArquivo *c) {
+    int fd = open(nome_binario, O_RDONLY);
+    if (fd < 0) {
+        iniciar_cabecalho(c);
+        return 0;
+    }
+    int tem_cabecalho = ler_cabecalho(fd, c);
+    if (!tem_cabecalho) {
+        struct stat st;
+        iniciar_cabecalho(c);
+        c->tam_cabecalho = 0;
+        c->quantidade = (fstat(fd, &st) == 0) ? st.st_size / (long)sizeof(Registro) : 0;
+    }
+    close(fd);
+    return tem_cabecalho;
+}
+
+void marcar_ordenado(const char *nome_binario, int ordem) {
+    CabecalhoArquivo c;
+    int fd = open(nome_binario, O_RDWR);
+    if (fd < 0 || !ler_cabecalho(fd, &c)) {
+        if (fd >= 0) close(fd);
+        return; // Arquivos legados não têm onde registrar a ordenação
+    }
+    c.chave = CHAVE_NOTA;
+    c.ordem = ordem;
+    escrever_cabecalho(fd, &c);
+    close(fd);
+}
+
+int copiar_se_ordenado(const char *origem, const char *destino, int quantidade, int ordem, Metricas *stats) {
+    CabecalhoArquivo c;
+    if (!consultar_binario(origem, &c) || c.chave != CHAVE_NOTA || c.ordem != ordem) {
+        return 0;
+    }
+
+    // Qualquer prefixo de um arquivo ordenado também está ordenado
+    Fita *entrada = abrir_fita_entrada(origem, &stats->blocos_lidos_pre);
+    Fita *saida = abrir_fita(destino, FITA_ESCRITA, &stats->blocos_escritos_pre);
+    limitar_fita(entrada, quantidade);
+    Registro reg;
+    while (ler_fita(entrada, &reg)) {
+        escrever_fita(saida, &reg);
+        stats->leituras_pre++;
+        stats->escritas_pre++;
+    }
+    fechar_fita(saida);
+    fechar_fita(entrada);
+    marcar_ordenado(destino, ordem);
+    return 1;
+}
+
+void copiar_binario_descritor(int fd_origem, const char *destino) {
+    int fd_destino = open(destino, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int tam_buffer = tamanho_bloco_atual();
+    char *buffer = (char *)alocar_temporario(tam_buffer);
+    if (fd_destino < 0 || !buffer) {
+        perror("Erro ao copiar o arquivo de saída");
+        exit(EXIT_FAILURE);
+    }
+    ssize_t lidos;
+    long deslocamento = 0;
+    while ((lidos = pread(fd_origem, buffer, tam_buffer, deslocamento)) != 0) {
+        if (lidos < 0) {
+            if (errno == EINTR) continue;
+            perror("Erro ao copiar o arquivo de saída");
+            exit(EXIT_FAILURE);
+        }
+        deslocamento += lidos;
+        ssize_t feito = 0;
+        while (feito < lidos) {
+            ssize_t r = write(fd_destino, buffer + feito, lidos - feito);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                perror("Erro ao copiar o arquivo de saída");
+                exit(EXIT_FAILURE);
+            }
+            feito += r;
+        }
+    }
+    close(fd_destino);
+    liberar_temporario(buffer);
+}
+
+int verificar_binario(const char *nome_binario) {
+    CabecalhoArquivo c;
+    int tem_cabecalho = consultar_binario(nome_binario, &c);
+
+    Fita *arquivo = abrir_fita(nome_binario, FITA_LEITURA, NULL);
+    Registro bloco[64];
+    uint64_t soma = 0;
+    long quantidade = 0;
+    int n;
+    while ((n = ler_registros_fita(arquivo, bloco, 64)) > 0) {
+        soma += soma_registros(bloco, n);
+        quantidade += n;
+    }
+    fechar_fita(arquivo);
+
+    printf("Arquivo: %s\n", nome_binario);
+    if (!tem_cabecalho) {
+        printf("Formato: legado (sem cabeçalho)\n");
+        printf("Registros: %ld\n", quantidade);
+        printf("Soma de verificação: %016llx\n", (unsigned long long)soma);
+        return 0;
+    }
+    printf("Formato: versão %u, registro de %u bytes\n", c.versao, c.tam_registro);
+    printf("Registros: %lld\n", (long long)c.quantidade);
+    if (c.chave == CHAVE_NOTA) {
+        printf("Ordenação: nota, %s\n", c.ordem == ORDEM_DESCENDENTE ? "descendente" : "ascendente");
+    } else {
+        printf("Ordenação: nenhuma\n");
+    }
+
+    int confere = (soma == c.soma && quantidade == c.quantidade);
+    printf("Soma de verificação: %016llx (%s)\n", (unsigned long long)c.soma, confere ? "confere" : "divergente");
+    return confere ? 0 : 1;
 }
 
 // Função para ler o arquivo PROVAO.TXT e armazenar os dados em um vetor de Registro
@@ -0,0 +1,496 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <setjmp.h>
+#include "../include/libordena.h"
+#include "../include/fita.h"
+#include "../include/ordenacao_interna.h"
+#include "../include/intercalacao2f.h"
+#include "../include/arvore_perdedores.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+
+#define ESTADO_INSERCAO 0
+#define ESTADO_EXTRACAO 1
+#define ESTADO_ERRO 2      // Uma fita falhou: só resta reiniciar ou destruir o contexto
+
+#define LIMITE_INSERCAO_LIB 16      // Trechos ordenados por inserção antes da intercalação
+
+// Chave extraída de um registro da área de trabalho (caminho com extrator ou comparador próprio)
+typedef struct {
+    double chave;
+    int indice;
+} ItemOrdena;
+
+// Intercalação de até FAN_IN_MAXIMO corridas do arquivo temporário atual. A árvore de
+// perdedores compara as notas direto ou, com extrator ou comparador próprio, as chaves
+// extraídas; empates saem pela corrida mais antiga (menor índice), o que mantém a estabilidade.
+typedef struct {
+    int k;                          // Fontes abertas
+    Fita *fontes[FAN_IN_MAXIMO];
+    Registro atuais[FAN_IN_MAXIMO]; // Registro corrente de cada fonte
+    double chaves[FAN_IN_MAXIMO];   // Chave extraída de cada fonte (só com extrator ou comparador)
+    ArvorePerdedores *arvore;
+} Intercalacao;
+
+struct ContextoOrdenacao {
+    OpcoesOrdena opcoes;
+    int estado;         // ESTADO_INSERCAO, ESTADO_EXTRACAO ou ESTADO_ERRO
+    int generico;       // 1 com extrator ou comparador próprio; 0: radix sobre a nota
+    long capacidade;    // Registros que cabem na área de trabalho
+    int fan_in;         // Corridas intercaladas por passada
+    Arena *arena;       // Memória do contexto: a área de trabalho ou as fitas da intercalação
+
+    // Área de trabalho: reservada da arena na inserção e devolvida a ela na intercalação
+    Registro *registros; // NULL enquanto devolvida
+    long n;
+    long pos;           // Próxima posição a extrair quando tudo coube na memória
+    ChaveRadix *radix;  // 2 * capacidade pares (a segunda metade é a área auxiliar)
+    ItemOrdena *itens;  // 2 * capacidade itens (idem)
+
+    // Corridas gravadas: alternam entre dois arquivos do gerenciador de temporários a cada passada
+    int temporarios[2]; // -1 enquanto o arquivo não foi reservado
+    int atual;
+    Fita *escrita;      // Fita que recebe as corridas durante a inserção
+    Fita *saida;        // Fita que recebe as corridas de uma passada da intercalação
+    long gravados;      // Registros já gravados nela
+    long *inicios;      // Primeiro registro de cada corrida
+    long *tamanhos;
+    int num_corridas;
+    int cap_corridas;
+    Intercalacao intercalacao;
+};
+
+void iniciar_opcoes_ordena(OpcoesOrdena *opcoes) {
+    memset(opcoes, 0, sizeof(OpcoesOrdena));
+    opcoes->ordem = ORDEM_ASCENDENTE;
+}
+
+static double extrair_chave(const ContextoOrdenacao *ctx, const Registro *r) {
+    return ctx->opcoes.extrair ? ctx->opcoes.extrair(r, ctx->opcoes.dados) : r->nota;
+}
+
+static int comparar_chaves(const ContextoOrdenacao *ctx, double a, double b) {
+    if (ctx->opcoes.comparar) return ctx->opcoes.comparar(a, b, ctx->opcoes.dados);
+    if (a == b) return 0;
+    int antes = (ctx->opcoes.ordem == ORDEM_DESCENDENTE) ? a > b : a < b;
+    return antes ? -1 : 1;
+}
+
+// Reserva a área de trabalho na arena do contexto (corrente)
+static int reservar_area(ContextoOrdenacao *ctx) {
+    if (ctx->registros) return ORDENA_OK;
+    ctx->registros = (Registro *)alocar_temporario(ctx->capacidade * sizeof(Registro));
+    if (ctx->generico) {
+        ctx->itens = (ItemOrdena *)alocar_temporario(2 * ctx->capacidade * sizeof(ItemOrdena));
+    } else {
+        ctx->radix = (ChaveRadix *)alocar_temporario(2 * ctx->capacidade * sizeof(ChaveRadix));
+    }
+    return (ctx->registros && (ctx->itens || ctx->radix)) ? ORDENA_OK : ORDENA_ERRO_MEMORIA;
+}
+
+// Devolve a área de trabalho à arena (a fita das corridas já foi fechada): a intercalação
+// reserva as fitas no mesmo espaço
+static void devolver_area(ContextoOrdenacao *ctx) {
+    liberar_temporario(ctx->itens);
+    liberar_temporario(ctx->radix);
+    liberar_temporario(ctx->registros);
+    ctx->itens = NULL;
+    ctx->radix = NULL;
+    ctx->registros = NULL;
+}
+
+ContextoOrdenacao *ordena_criar(const OpcoesOrdena *opcoes) {
+    ContextoOrdenacao *ctx = (ContextoOrdenacao *)calloc(1, sizeof(ContextoOrdenacao));
+    if (!ctx) return NULL;
+    if (opcoes) ctx->opcoes = *opcoes;
+    else iniciar_opcoes_ordena(&ctx->opcoes);
+    ctx->temporarios[0] = ctx->temporarios[1] = -1;
+    ctx->generico = ctx->opcoes.extrair || ctx->opcoes.comparar;
+
+    // Plano de memória do contexto: na inserção, a área de trabalho e a fita das corridas;
+    // na intercalação, uma fita por corrida e a fita de saída da passada
+    long memoria = ctx->opcoes.memoria;
+    if (memoria <= 0) memoria = orcamento_memoria() > 0 ? orcamento_memoria() : MEMORIA_PADRAO_LIB;
+    long disponivel = memoria - FOLGA_RESERVAS_PLANO;
+    long fita = bytes_fita(sizeof(Registro));
+    long por_registro = sizeof(Registro) + 2 * (ctx->generico ? sizeof(ItemOrdena) : sizeof(ChaveRadix));
+    ctx->capacidade = (disponivel - fita) / por_registro;
+    if (ctx->capacidade < MIN_MEMORIA_PLANO) ctx->capacidade = MIN_MEMORIA_PLANO;
+    if (ctx->capacidade > INT_MAX / 2) ctx->capacidade = INT_MAX / 2;
+
+    long arvore = sizeof(ArvorePerdedores);
+    long fan_in = (disponivel - fita - arvore) / (fita + (long)BYTES_FOLHA_ARVORE);
+    if (fan_in > FAN_IN_MAXIMO) fan_in = FAN_IN_MAXIMO;
+    if (fan_in < 2) fan_in = 2;
+    ctx->fan_in = (int)fan_in;
+
+    long bytes = ctx->capacidade * por_registro + fita;
+    long intercalacao = (fan_in + 1) * fita + arvore + fan_in * (long)BYTES_FOLHA_ARVORE;
+    if (intercalacao > bytes) bytes = intercalacao;
+    ctx->arena = criar_arena(bytes + FOLGA_RESERVAS_PLANO);
+    if (!ctx->arena) {
+        free(ctx);
+        return NULL;
+    }
+    Arena *anterior = usar_arena(ctx->arena);
+    int r = reservar_area(ctx);
+    usar_arena(anterior);
+    if (r != ORDENA_OK) {
+        destruir_arena(ctx->arena);
+        free(ctx);
+        return NULL;
+    }
+    ctx->estado = ESTADO_INSERCAO;
+    return ctx;
+}
+
+// Ordenação estável dos itens pelo comparador: inserção em trechos pequenos e
+// intercalação ascendente (bottom-up) alternando entre 'v' e 'aux'
+static void ordenar_itens(const ContextoOrdenacao *ctx, ItemOrdena *v, ItemOrdena *aux, long n) {
+    for (long ini = 0; ini < n; ini += LIMITE_INSERCAO_LIB) {
+        long fim = (ini + LIMITE_INSERCAO_LIB < n) ? ini + LIMITE_INSERCAO_LIB : n;
+        for (long i = ini + 1; i < fim; i++) {
+            ItemOrdena x = v[i];
+            long j = i - 1;
+            while (j >= ini && comparar_chaves(ctx, x.chave, v[j].chave) < 0) {
+                v[j + 1] = v[j];
+                j--;
+            }
+            v[j + 1] = x;
+        }
+    }
+
+    ItemOrdena *origem = v, *destino = aux;
+    for (long largura = LIMITE_INSERCAO_LIB; largura < n; largura *= 2) {
+        for (long ini = 0; ini < n; ini += 2 * largura) {
+            long meio = (ini + largura < n) ? ini + largura : n;
+            long fim = (ini + 2 * largura < n) ? ini + 2 * largura : n;
+            long i = ini, j = meio, k = ini;
+            // Só passa o item da direita à frente se ele for estritamente menor (estabilidade)
+            while (i < meio && j < fim) {
+                destino[k++] = (comparar_chaves(ctx, origem[j].chave, origem[i].chave) < 0) ? origem[j++] : origem[i++];
+            }
+            while (i < meio) destino[k++] = origem[i++];
+            while (j < fim) destino[k++] = origem[j++];
+        }
+        ItemOrdena *temp = origem;
+        origem = destino;
+        destino = temp;
+    }
+    if (origem != v) memcpy(v, origem, n * sizeof(ItemOrdena));
+}
+
+// Ordena os índices da área de trabalho (os registros não saem do lugar)
+static void ordenar_area(ContextoOrdenacao *ctx) {
+    if (ctx->n == 0) return;
+    if (!ctx->generico) {
+        ordenar_indices_radix(ctx->registros, ctx->radix, (int)ctx->n, ctx->opcoes.ordem);
+        return;
+    }
+    for (long i = 0; i < ctx->n; i++) {
+        ctx->itens[i].chave = extrair_chave(ctx, &ctx->registros[i]);
+        ctx->itens[i].indice = (int)i;
+    }
+    ordenar_itens(ctx, ctx->itens, ctx->itens + ctx->capacidade, ctx->n);
+}
+
+// Posição na área de trabalho do k-ésimo registro na ordem pedida
+static long indice_ordenado(const ContextoOrdenacao *ctx, long k) {
+    return ctx->generico ? ctx->itens[k].indice : ctx->radix[k].indice;
+}
+
+static int reservar_temporario(ContextoOrdenacao *ctx, int i) {
+    if (ctx->temporarios[i] >= 0) return ORDENA_OK;
+    ctx->temporarios[i] = tentar_reservar_arquivo_temporario(ctx->opcoes.diretorio);
+    return (ctx->temporarios[i] >= 0) ? ORDENA_OK : ORDENA_ERRO_ARQUIVO;
+}
+
+static int registrar_corrida(ContextoOrdenacao *ctx, int i, long inicio, long tamanho) {
+    if (i >= ctx->cap_corridas) {
+        int nova = ctx->cap_corridas ? 2 * ctx->cap_corridas : 64;
+        long *inicios = (long *)realloc(ctx->inicios, nova * sizeof(long));
+        if (inicios) ctx->inicios = inicios;
+        long *tamanhos = (long *)realloc(ctx->tamanhos, nova * sizeof(long));
+        if (tamanhos) ctx->tamanhos = tamanhos;
+        if (!inicios || !tamanhos) return ORDENA_ERRO_MEMORIA;
+        ctx->cap_corridas = nova;
+    }
+    ctx->inicios[i] = inicio;
+    ctx->tamanhos[i] = tamanho;
+    return ORDENA_OK;
+}
+
+// Ordena a área de trabalho e a grava como uma nova corrida no arquivo temporário
+static int gravar_corrida(ContextoOrdenacao *ctx) {
+    if (!ctx->escrita) {
+        if (reservar_temporario(ctx, 0) != ORDENA_OK) return ORDENA_ERRO_ARQUIVO;
+        ctx->atual = 0;
+        ctx->escrita = abrir_fita_temporaria(ctx->temporarios[0], FITA_ESCRITA, NULL);
+        ctx->gravados = 0;
+    }
+    if (registrar_corrida(ctx, ctx->num_corridas, ctx->gravados, ctx->n) != ORDENA_OK) {
+        return ORDENA_ERRO_MEMORIA;
+    }
+    ordenar_area(ctx);
+    for (long k = 0; k < ctx->n; k++) {
+        escrever_fita(ctx->escrita, &ctx->registros[indice_ordenado(ctx, k)]);
+    }
+    ctx->num_corridas++;
+    ctx->gravados += ctx->n;
+    ctx->n = 0;
+    return ORDENA_OK;
+}
+
+static int inserir(ContextoOrdenacao *ctx, const Registro *registros, long n) {
+    if (ctx->estado != ESTADO_INSERCAO) return ORDENA_ERRO_ESTADO;
+    while (n > 0) {
+        if (ctx->n == ctx->capacidade) {
+            int r = gravar_corrida(ctx);
+            if (r != ORDENA_OK) return r;
+        }
+
+        long cabem = ctx->capacidade - ctx->n;
+        if (cabem > n) cabem = n;
+        memcpy(ctx->registros + ctx->n, registros, cabem * sizeof(Registro));
+        ctx->n += cabem;
+        registros += cabem;
+        n -= cabem;
+    }
+    return ORDENA_OK;
+}
+
+// Comparador da árvore de perdedores para as chaves extraídas
+static int comparar_fontes(int x, int y, void *dados) {
+    ContextoOrdenacao *ctx = (ContextoOrdenacao *)dados;
+    return comparar_chaves(ctx, ctx->intercalacao.chaves[x], ctx->intercalacao.chaves[y]);
+}
+
+// Entrega à árvore o registro corrente da fonte f, ou a marca como esgotada
+static void avancar_fonte(ContextoOrdenacao *ctx, int f, int construindo) {
+    Intercalacao *in = &ctx->intercalacao;
+    int ativa = ler_fita(in->fontes[f], &in->atuais[f]);
+    float nota = ativa ? in->atuais[f].nota : 0;
+    if (ativa && ctx->generico) in->chaves[f] = extrair_chave(ctx, &in->atuais[f]);
+    if (construindo) {
+        in->arvore->chaves[f] = nota;
+        in->arvore->ativa[f] = ativa;
+    } else {
+        atualizar_arvore_perdedores(in->arvore, f, nota, ativa);
+    }
+}
+
+// Abre as corridas [primeira, primeira + k) do arquivo atual e monta a árvore das fontes
+static int iniciar_intercalacao(ContextoOrdenacao *ctx, int primeira, int k) {
+    Intercalacao *in = &ctx->intercalacao;
+    in->arvore = criar_arvore_perdedores(k, ctx->opcoes.ordem, NULL);
+    if (!in->arvore) return ORDENA_ERRO_MEMORIA;
+    if (ctx->generico) {
+        in->arvore->comparar = comparar_fontes;
+        in->arvore->dados = ctx;
+    }
+    for (int i = 0; i < k; i++) {
+        in->fontes[i] = abrir_fita_temporaria_em(ctx->temporarios[ctx->atual], ctx->inicios[primeira + i], NULL);
+        in->k = i + 1;
+        limitar_fita(in->fontes[i], ctx->tamanhos[primeira + i]);
+        avancar_fonte(ctx, i, 1);
+    }
+    construir_arvore_perdedores(in->arvore);
+    return ORDENA_OK;
+}
+
+// Retira o próximo registro da intercalação; retorna 0 quando todas as fontes se esgotam
+static int proximo_intercalacao(ContextoOrdenacao *ctx, Registro *r) {
+    Intercalacao *in = &ctx->intercalacao;
+    int f = vencedora_arvore_perdedores(in->arvore);
+    if (f < 0) return 0;
+    *r = in->atuais[f];
+    avancar_fonte(ctx, f, 0);
+    return 1;
+}
+
+// Fecha as fontes (na ordem inversa à de abertura) e libera a árvore
+static void encerrar_intercalacao(ContextoOrdenacao *ctx) {
+    Intercalacao *in = &ctx->intercalacao;
+    for (int i = in->k - 1; i >= 0; i--) {
+        fechar_fita(in->fontes[i]);
+    }
+    in->k = 0;
+    liberar_arvore_perdedores(in->arvore);
+    in->arvore = NULL;
+}
+
+// Intercala as corridas em grupos de fan_in, gravando as novas corridas no outro arquivo
+static int passada(ContextoOrdenacao *ctx) {
+    int destino = 1 - ctx->atual;
+    if (reservar_temporario(ctx, destino) != ORDENA_OK) return ORDENA_ERRO_ARQUIVO;
+    ctx->saida = abrir_fita_temporaria(ctx->temporarios[destino], FITA_ESCRITA, NULL);
+
+    int novas = 0;
+    long gravados = 0;
+    for (int primeira = 0; primeira < ctx->num_corridas; primeira += ctx->fan_in) {
+        int k = ctx->num_corridas - primeira;
+        if (k > ctx->fan_in) k = ctx->fan_in;
+        long inicio = gravados;
+        int r = iniciar_intercalacao(ctx, primeira, k);
+        if (r != ORDENA_OK) return r;
+        Registro atual;
+        while (proximo_intercalacao(ctx, &atual)) {
+            escrever_fita(ctx->saida, &atual);
+            gravados++;
+        }
+        encerrar_intercalacao(ctx);
+        // A nova corrida ocupa uma posição já consumida da lista (novas <= primeira)
+        registrar_corrida(ctx, novas++, inicio, gravados - inicio);
+    }
+    fechar_fita(ctx->saida);
+    ctx->saida = NULL;
+    ctx->num_corridas = novas;
+    ctx->atual = destino;
+    return ORDENA_OK;
+}
+
+// Grava a última corrida e intercala as corridas até restarem no máximo fan_in
+static int reduzir_corridas(ContextoOrdenacao *ctx) {
+    if (ctx->n > 0) {
+        int r = gravar_corrida(ctx);
+        if (r != ORDENA_OK) return r;
+    }
+    fechar_fita(ctx->escrita);
+    ctx->escrita = NULL;
+    devolver_area(ctx);
+
+    while (ctx->num_corridas > ctx->fan_in) {
+        int r = passada(ctx);
+        if (r != ORDENA_OK) return r;
+    }
+    // A última intercalação é consumida aos poucos por ordena_extrair
+    return iniciar_intercalacao(ctx, 0, ctx->num_corridas);
+}
+
+static int finalizar(ContextoOrdenacao *ctx) {
+    if (ctx->estado != ESTADO_INSERCAO) return ORDENA_ERRO_ESTADO;
+    ctx->pos = 0;
+
+    // Tudo coube na memória: nenhum arquivo é usado
+    if (ctx->num_corridas == 0) {
+        ordenar_area(ctx);
+        ctx->estado = ESTADO_EXTRACAO;
+        return ORDENA_OK;
+    }
+
+    int r = reduzir_corridas(ctx);
+    ctx->estado = (r == ORDENA_OK) ? ESTADO_EXTRACAO : ESTADO_ERRO;
+    return r;
+}
+
+static long extrair(ContextoOrdenacao *ctx, Registro *destino, long max) {
+    if (ctx->estado != ESTADO_EXTRACAO) return ORDENA_ERRO_ESTADO;
+    long feitos = 0;
+    if (ctx->num_corridas == 0) {
+        while (feitos < max && ctx->pos < ctx->n) {
+            destino[feitos++] = ctx->registros[indice_ordenado(ctx, ctx->pos++)];
+        }
+    } else {
+        while (feitos < max && proximo_intercalacao(ctx, &destino[feitos])) {
+            feitos++;
+        }
+    }
+    return feitos;
+}
+
+static void reiniciar(ContextoOrdenacao *ctx) {
+    // O conteúdo das fitas é descartado: nada é gravado (uma fita que falhou falharia de novo)
+    for (int i = ctx->intercalacao.k - 1; i >= 0; i--) {
+        descartar_fita(ctx->intercalacao.fontes[i]);
+    }
+    ctx->intercalacao.k = 0;
+    liberar_arvore_perdedores(ctx->intercalacao.arvore);
+    ctx->intercalacao.arvore = NULL;
+    descartar_fita(ctx->saida);
+    descartar_fita(ctx->escrita);
+    ctx->saida = NULL;
+    ctx->escrita = NULL;
+    // Os arquivos voltam vazios ao gerenciador, que os entrega à próxima reserva
+    for (int i = 0; i < 2; i++) {
+        if (ctx->temporarios[i] >= 0) devolver_arquivo_temporario(ctx->temporarios[i]);
+        ctx->temporarios[i] = -1;
+    }
+    // A arena comporta a área de trabalho assim que as fitas são fechadas; a restauração
+    // recupera também o que uma chamada interrompida por erro tenha deixado reservado
+    devolver_area(ctx);
+    restaurar_arena(0);
+    reservar_area(ctx);
+    ctx->num_corridas = 0;
+    ctx->n = 0;
+    ctx->pos = 0;
+    ctx->estado = ESTADO_INSERCAO;
+}
+
+// As funções públicas reservam da arena do contexto e devolvem a corrente ao retornar. Uma
+// falha de E/S em uma fita volta, pelo tratador de erros das fitas, ao ponto de entrada da
+// chamada, que retorna ORDENA_ERRO_ARQUIVO em vez de encerrar o programa.
+
+static jmp_buf *retorno_erro; // Ponto de entrada da chamada em andamento
+
+static void tratar_erro_fita(const char *mensagem) {
+    (void)mensagem;
+    longjmp(*retorno_erro, 1);
+}
+
+static Arena *entrar(ContextoOrdenacao *ctx, jmp_buf *retorno) {
+    retorno_erro = retorno;
+    definir_tratador_erro_fita(tratar_erro_fita);
+    return usar_arena(ctx->arena);
+}
+
+static void sair(Arena *anterior) {
+    usar_arena(anterior);
+    definir_tratador_erro_fita(NULL);
+}
+
+static int falhar(ContextoOrdenacao *ctx) {
+    ctx->estado = ESTADO_ERRO;
+    return ORDENA_ERRO_ARQUIVO;
+}
+
+int ordena_inserir(ContextoOrdenacao *ctx, const Registro *registros, long n) {
+    jmp_buf retorno;
+    Arena *anterior = entrar(ctx, &retorno);
+    int r = setjmp(retorno) ? falhar(ctx) : inserir(ctx, registros, n);
+    sair(anterior);
+    return r;
+}
+
+int ordena_finalizar(ContextoOrdenacao *ctx) {
+    jmp_buf retorno;
+    Arena *anterior = entrar(ctx, &retorno);
+    int r = setjmp(retorno) ? falhar(ctx) : finalizar(ctx);
+    sair(anterior);
+    return r;
+}
+
+long ordena_extrair(ContextoOrdenacao *ctx, Registro *destino, long max) {
+    jmp_buf retorno;
+    Arena *anterior = entrar(ctx, &retorno);
+    long r = setjmp(retorno) ? falhar(ctx) : extrair(ctx, destino, max);
+    sair(anterior);
+    return r;
+}
+
+void ordena_reiniciar(ContextoOrdenacao *ctx) {
+    Arena *anterior = usar_arena(ctx->arena);
+    reiniciar(ctx);
+    usar_arena(anterior);
+}
+
+void ordena_destruir(ContextoOrdenacao *ctx) {
+    if (!ctx) return;
+    ordena_reiniciar(ctx);
+    destruir_arena(ctx->arena);
+    free(ctx->inicios);
+    free(ctx->tamanhos);
+    free(ctx);
+}
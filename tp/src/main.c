@@ -2,87 +2,222 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-#include "../include/intercalacao1f.h"
+#include "../include/metodos.h"
 #include "../include/intercalacao2f.h"
-#include "../include/quicksort_ext.h"
+#include "../include/selecao_top.h"
+#include "../include/conversor.h"
+#include "../include/benchmark.h"
+#include "../include/gerador.h"
+#include "../include/memoria.h"
+#include "../include/arquivos_temporarios.h"
+#include "../include/ordenacao_adaptativa.h"
 #include "../include/utils.h"
 #include "../include/registro.h"
 #include "../include/leitura.h"
+#include "../include/fita.h"
 
-#define MAX_SITUACAO 20
+// Com --saida, informa onde o método gravou o arquivo ordenado
+static void informar_saida(const char *destino) {
+    if (!destino) return;
+    printf("Resultado ordenado gravado em %s\n", destino);
+}
+
+// Subcomando de conversão: ordena converter [PROVAO.TXT] [saida.bin] [quantidade]
+static int executar_conversao(int argc, char *argv[]) {
+    const char *texto = (argc > 2) ? argv[2] : ARQUIVO_PROVAO;
+    const char *binario = (argc > 3) ? argv[3] : ARQUIVO_REGISTROS;
+    long quantidade = (argc > 4) ? atol(argv[4]) : 0;
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    long convertidos = converter_provao(texto, binario, quantidade);
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    printf("%ld registros convertidos de %s para %s em %.3f segundos\n", convertidos, texto, binario, segundos);
+    return 0;
+}
+
+// Subcomando de geração: ordena gerar [quantidade] [distribuicao] [saida.bin] [opções]
+static int executar_geracao(int argc, char *argv[]) {
+    ParametrosGerador p;
+    iniciar_parametros_gerador(&p);
+    long quantidade = 0;
+    const char *binario = ARQUIVO_REGISTROS;
+    int posicional = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            p.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--distintos") == 0 && i + 1 < argc) {
+            p.distintos = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--expoente") == 0 && i + 1 < argc) {
+            p.expoente = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--ruido") == 0 && i + 1 < argc) {
+            p.ruido = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--casas") == 0 && i + 1 < argc) {
+            p.casas = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            p.threads = atoi(argv[++i]);
+        } else if (posicional == 0) {
+            quantidade = atol(argv[i]);
+            posicional++;
+        } else if (posicional == 1) {
+            p.distribuicao = distribuicao_por_nome(argv[i]);
+            posicional++;
+        } else if (posicional == 2) {
+            binario = argv[i];
+            posicional++;
+        } else {
+            printf("Argumento desconhecido: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (quantidade <= 0 || p.distribuicao < 0 || p.casas < 0 || p.casas > MAX_CASAS_GERADOR ||
+        p.distintos < 1 || p.ruido < 0.0 || p.ruido > 100.0) {
+        printf("Uso: ordena gerar <quantidade> [ordenada|inversa|aleatoria|duplicadas|zipf|ruido] [saida.bin]\n"
+               "                   [--semente S] [--distintos D] [--expoente S] [--ruido PORCENTAGEM]\n"
+               "                   [--casas 0-%d] [--threads T]\n", MAX_CASAS_GERADOR);
+        return 1;
+    }
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    gerar_registros(binario, quantidade, &p);
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    double megabytes = (TAM_CABECALHO + quantidade * (double)sizeof(Registro)) / 1e6;
+    printf("%ld registros gerados em %s em %.3f segundos (%.1f MB/s)\n", quantidade, binario, segundos,
+           segundos > 0 ? megabytes / segundos : 0.0);
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
-    if (argc < 4 || argc > 5) {
-        printf("Uso: ordena <metodo> <quantidade> <situacao> [-P]\n");
+    if (argc >= 2 && strcmp(argv[1], "converter") == 0) {
+        return executar_conversao(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "info") == 0) {
+        // Subcomando de inspeção: ordena info [arquivo.bin]
+        return verificar_binario(argc > 2 ? argv[2] : ARQUIVO_REGISTROS);
+    }
+    if (argc >= 2 && strcmp(argv[1], "gerar") == 0) {
+        return executar_geracao(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        return executar_benchmark(argc, argv);
+    }
+
+    if (argc < 4) {
+        printf("Uso: ordena <metodo> <quantidade> <situacao> [-P] [--corridas heap|radix] [--bloco bytes] [--mmap] [--sem-pre-analise] [--top K] [--saida arquivo.bin] [--metricas texto|json|csv] [--mem bytes[K|M|G]] [--tmp diretorio]\n");
+        printf("     ordena converter [PROVAO.TXT] [saida.bin] [quantidade]\n");
+        printf("     ordena info [arquivo.bin]\n");
+        printf("     ordena gerar <quantidade> [distribuicao] [saida.bin] [--semente S] ...\n");
+        printf("     ordena bench [--metodos 1,2,...] [--quantidades N1,N2,...] [--repeticoes R] [--csv saida.csv] ...\n");
         return 1;
     }
 
     int metodo;
     int quantidade;
     int situacao_int;
-    char situacao[MAX_SITUACAO];
     int imprimir = 0;
-    int imprimir_aqui = 0;
+    int top = 0; // Com --top K, seleciona só os K primeiros registros em vez de ordenar todos
+    const char *saida_binaria = NULL; // Com --saida, o resultado ordenado é gravado nesse arquivo
 
     // Leitura dos parâmetros
-    metodo = atoi(argv[1]);  // Modificado para ser um número inteiro de 1 a 3
+    metodo = atoi(argv[1]);  // Modificado para ser um número inteiro de 1 a 6
     quantidade = atoi(argv[2]);
     situacao_int = atoi(argv[3]);
 
-    // Convertendo a situação para string
-    switch (situacao_int) {
-        case 1:
-            strcpy(situacao, "1");
-            break;
-        case 2:
-            strcpy(situacao, "2");
-            break;
-        case 3:
-            strcpy(situacao, "3");
-            break;
-        default:
-            printf("Situacao inválida. Use 1, 2 ou 3.\n");
-            return 1;
-    }
-
-    // Verifica se o argumento opcional -P foi passado
-    if (argc == 5 && strcmp(argv[4], "-P") == 0) {
-        imprimir = 1;
+    if (situacao_int < 1 || situacao_int > 3) {
+        printf("Situacao inválida. Use 1, 2 ou 3.\n");
+        return 1;
     }
 
-    Registro *registros = NULL;
-    //ler_provao("./data/PROVAO.TXT", &registros, quantidade, situacao_int);
-    ler_binario("./data/registros.bin", &registros, quantidade);
-
-    Metricas stats = {0, 0, 0, 0.0, 0, 0, 0, 0.0};
-
-    // Usando switch para selecionar o método de ordenação
-    switch (metodo) {
-        case 1:
-            if (situacao_int == 1) {
-                intercalacao_balanceada_2f_ascendente(argv[2], quantidade, situacao_int, &stats, imprimir);
-                imprimir_aqui = 1;
+    // Argumentos opcionais
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "-P") == 0) {
+            imprimir = 1;
+        } else if (strcmp(argv[i], "--corridas") == 0 && i + 1 < argc) {
+            // Força o método de geração das corridas iniciais das intercalações
+            i++;
+            if (strcmp(argv[i], "heap") == 0) {
+                definir_modo_corridas(CORRIDAS_HEAP);
+            } else if (strcmp(argv[i], "radix") == 0) {
+                definir_modo_corridas(CORRIDAS_RADIX);
+            } else {
+                printf("Modo de corridas inválido. Use heap ou radix.\n");
+                return 1;
             }
-            else {
-                intercalacao_balanceada_2f_descendente(argv[2], quantidade, situacao_int, &stats, imprimir);
-                imprimir_aqui = 1;
+        } else if (strcmp(argv[i], "--bloco") == 0 && i + 1 < argc) {
+            // Tamanho do bloco de E/S das fitas, em bytes
+            int bytes = atoi(argv[++i]);
+            if (bytes < (int)sizeof(Registro)) {
+                printf("Tamanho de bloco inválido: use ao menos %d bytes.\n", (int)sizeof(Registro));
+                return 1;
             }
-
-        case 2:
-            intercalacao_balanceada_1f(argv[2], quantidade, situacao_int);
-            break;
-        case 3:
-            quicksort_externo("./data/registros.bin", quantidade, situacao_int, imprimir);
-            imprimir_aqui = 1;
-            break;
-        default:
-            printf("Metodo de ordenacao desconhecido.\n");
+            definir_tamanho_bloco(bytes);
+        } else if (strcmp(argv[i], "--sem-pre-analise") == 0) {
+            // Desativa a detecção de entrada ordenada, inversa ou quase ordenada
+            definir_pre_analise(0);
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+            if (top < 1) {
+                printf("Valor de --top inválido: use K >= 1.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            // Grava o resultado em binário (com cabeçalho) em vez de apenas imprimi-lo
+            saida_binaria = argv[++i];
+        } else if (strcmp(argv[i], "--metricas") == 0 && i + 1 < argc) {
+            // Formato do relatório de métricas (json e csv incluem o detalhamento por fase)
+            i++;
+            if (strcmp(argv[i], "texto") == 0) {
+                definir_formato_metricas(METRICAS_TEXTO);
+            } else if (strcmp(argv[i], "json") == 0) {
+                definir_formato_metricas(METRICAS_JSON);
+            } else if (strcmp(argv[i], "csv") == 0) {
+                definir_formato_metricas(METRICAS_CSV);
+            } else {
+                printf("Formato de métricas inválido. Use texto, json ou csv.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--mem") == 0 && i + 1 < argc) {
+            // Orçamento de memória: cada método deriva dele a área de trabalho, o fan-in e o bloco
+            long bytes = ler_tamanho_memoria(argv[++i]);
+            if (bytes < (long)sizeof(Registro)) {
+                printf("Orçamento de memória inválido: use ao menos %d bytes (aceita sufixos K, M e G).\n", (int)sizeof(Registro));
+                return 1;
+            }
+            definir_orcamento_memoria(bytes);
+        } else if (strcmp(argv[i], "--tmp") == 0 && i + 1 < argc) {
+            // Diretório dos arquivos temporários (ex.: um tmpfs); os arquivos são criados sem nome
+            definir_diretorio_temporario(argv[++i]);
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            // Lê a entrada direto de um mapeamento em memória em vez de read() por blocos
+            definir_entrada_mapeada(1);
+        } else {
+            printf("Argumento desconhecido: %s\n", argv[i]);
             return 1;
-    }
-    if (imprimir == 1 && imprimir_aqui == 0) {
-        for (int i = 0; i < quantidade; i++) {
-            print_registro(&registros[i]);
         }
     }
+
+    // Os métodos leem ARQUIVO_REGISTROS diretamente do disco, sem carregá-lo inteiro em memória
+    // e exportam o resultado direto para o destino de --saida
+    Metricas stats = {0};
+    definir_destino_saida(saida_binaria);
+
+    if (top > 0) {
+        selecionar_top(ARQUIVO_REGISTROS, quantidade, top, situacao_int, &stats, imprimir);
+        informar_saida(saida_binaria);
+        return 0;
+    }
+
+    if (!executar_metodo(metodo, ARQUIVO_REGISTROS, quantidade, situacao_int, &stats, imprimir)) {
+        printf("Metodo de ordenacao desconhecido.\n");
+        return 1;
+    }
+
+    informar_saida(saida_binaria);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "../include/memoria.h"
+#include "../include/fita.h"
+#include "../include/registro.h"
+#include "../include/arvore_perdedores.h"
+#include "../include/arena.h"
+
+static long orcamento = 0; // Em bytes (0: sem orçamento)
+
+void definir_orcamento_memoria(long bytes) {
+    orcamento = bytes;
+}
+
+long orcamento_memoria(void) {
+    return orcamento;
+}
+
+long ler_tamanho_memoria(const char *texto) {
+    char *fim;
+    double valor = strtod(texto, &fim);
+    switch (*fim) {
+        case 'k': case 'K': valor *= 1024.0; fim++; break;
+        case 'm': case 'M': valor *= 1024.0 * 1024.0; fim++; break;
+        case 'g': case 'G': valor *= 1024.0 * 1024.0 * 1024.0; fim++; break;
+        default: break;
+    }
+    if (fim == texto || *fim != '\0' || valor < 1.0 || valor > (double)LONG_MAX) return 0;
+    return (long)valor;
+}
+
+// Limita o fan-in ao do método e ao da árvore de perdedores
+static long limitar_fan_in(long fan_in, const RequisitosMemoria *req) {
+    if (fan_in > req->max_fan_in) fan_in = req->max_fan_in;
+    if (fan_in > FAN_IN_MAXIMO) fan_in = FAN_IN_MAXIMO;
+    if (fan_in < 2) fan_in = 2;
+    return fan_in;
+}
+
+void planejar_memoria(const RequisitosMemoria *req, long quantidade, PlanoMemoria *plano, Metricas *stats) {
+    long memoria, fan_in = 0;
+
+    if (orcamento <= 0) {
+        // Um bloco derivado por um plano anterior com orçamento não vale mais
+        if (!bloco_definido()) ajustar_tamanho_bloco(TAM_BLOCO_PADRAO);
+    } else if (!bloco_definido()) {
+        // Bloco: uma fração fixa do orçamento
+        long bloco = orcamento / BLOCOS_POR_ORCAMENTO;
+        if (bloco > TAM_BLOCO_MAXIMO_PLANO) bloco = TAM_BLOCO_MAXIMO_PLANO;
+        bloco -= bloco % (long)sizeof(Registro);
+        if (bloco < (long)sizeof(Registro)) bloco = sizeof(Registro);
+        ajustar_tamanho_bloco((int)bloco);
+    }
+
+    // Uma fita de itens de um byte enche o bloco inteiro: cobre fitas de registros e de itens
+    long fita = bytes_fita(1);
+    long fixas = req->buffers_fixos * fita;
+    // Memória por via aberta junto com a área de trabalho e, se houver, na intercalação
+    long via_trabalho = req->buffers_geracao * fita + (req->buffers_por_fita > 0 ? 0 : req->bytes_por_via);
+    long via_intercalacao = req->buffers_por_fita * fita + req->bytes_por_via;
+
+    if (orcamento <= 0) {
+        memoria = req->padrao;
+        if (req->max_fan_in > 0) {
+            fan_in = limitar_fan_in(req->buffers_por_fita > 0 ? req->padrao : req->max_fan_in, req);
+        }
+    } else {
+        long disponivel = orcamento - FOLGA_RESERVAS_PLANO;
+
+        // Fan-in: as vias da intercalação cabem no orçamento; as abertas junto com a área de
+        // trabalho ficam com até metade dele
+        if (req->max_fan_in > 0) {
+            fan_in = LONG_MAX;
+            if (req->buffers_por_fita > 0) fan_in = (disponivel - fixas) / via_intercalacao;
+            if (via_trabalho > 0 && fan_in > disponivel / 2 / via_trabalho) fan_in = disponivel / 2 / via_trabalho;
+            fan_in = limitar_fan_in(fan_in, req);
+        }
+
+        // Área de trabalho: o restante, descontado o que fica aberto junto com ela
+        memoria = (disponivel - req->bytes_fixos - fixas - fan_in * via_trabalho) / req->bytes_por_item;
+        if (memoria > quantidade) memoria = quantidade;
+        if (memoria > INT_MAX / 2) memoria = INT_MAX / 2;
+        if (memoria < MIN_MEMORIA_PLANO) memoria = MIN_MEMORIA_PLANO;
+    }
+
+    // Maior das fases: área de trabalho e, se houver, intercalação
+    long bytes = req->bytes_fixos + fixas + fan_in * via_trabalho + memoria * req->bytes_por_item;
+    if (req->buffers_por_fita > 0 && fixas + fan_in * via_intercalacao > bytes) {
+        bytes = fixas + fan_in * via_intercalacao;
+    }
+
+    plano->memoria = (int)memoria;
+    plano->fan_in = (int)fan_in;
+    plano->bloco = tamanho_bloco_atual();
+    plano->bytes = bytes + FOLGA_RESERVAS_PLANO;
+    dimensionar_arena(plano->bytes);
+
+    stats->memoria_orcamento = orcamento;
+    stats->memoria_plano = plano->memoria;
+    stats->fan_in_plano = plano->fan_in;
+    stats->bloco_plano = plano->bloco;
+    stats->bytes_plano = plano->bytes;
+}
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include "../include/metodos.h"
+#include "../include/intercalacao1f.h"
+#include "../include/intercalacao2f.h"
+#include "../include/quicksort_ext.h"
+#include "../include/ordenacao_etiquetas.h"
+#include "../include/ordenacao_amostragem.h"
+#include "../include/ordenacao_contagem.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+
+const char *arquivo_saida_metodo(int metodo) {
+    switch (metodo) {
+        case 1: return ARQUIVO_SAIDA_2F;
+        case 2: return ARQUIVO_SAIDA_1F;
+        case 3: return ARQUIVO_SAIDA_QS;
+        case 4: return ARQUIVO_SAIDA_ETIQUETAS;
+        case 5: return ARQUIVO_SAIDA_AMOSTRAGEM;
+        case 6: return ARQUIVO_SAIDA_CONTAGEM;
+        default: return NULL;
+    }
+}
+
+int executar_metodo(int metodo, const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
+    if (!arquivo_saida_metodo(metodo)) return 0;
+
+    // As áreas temporárias do método saem da arena, dimensionada pelo plano de memória dele
+    ativar_arena();
+    reiniciar_uso_temporarios();
+    switch (metodo) {
+        case 1:
+            if (ordem_da_situacao(situacao) == ORDEM_ASCENDENTE) {
+                intercalacao_balanceada_2f_ascendente(arquivo, quantidade, situacao, stats, imprime);
+            }
+            else {
+                intercalacao_balanceada_2f_descendente(arquivo, quantidade, situacao, stats, imprime);
+            }
+            break;
+        case 2:
+            intercalacao_balanceada_1f(arquivo, quantidade, situacao, stats, imprime);
+            break;
+        case 3:
+            quicksort_externo((char *)arquivo, quantidade, situacao, stats, imprime);
+            break;
+        case 4:
+            ordenacao_por_etiquetas(arquivo, quantidade, situacao, stats, imprime);
+            break;
+        case 5:
+            ordenacao_por_amostragem(arquivo, quantidade, situacao, stats, imprime);
+            break;
+        case 6:
+            ordenacao_por_contagem(arquivo, quantidade, situacao, stats, imprime);
+            break;
+    }
+    desativar_arena();
+    return 1;
+}
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/intercalacao2f.h"
+#include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/arena.h"
+
+static int pre_analise_ativa = 1;
+
+void definir_pre_analise(int ativa) {
+    pre_analise_ativa = ativa;
+}
+
+void analisar_entrada(const char *arquivo, const char *destino, int quantidade, int tam_memoria,
+                      int usa_naturais, int ordem, AnaliseEntrada *analise, Metricas *stats) {
+    int ordem_inversa = (ordem == ORDEM_ASCENDENTE) ? ORDEM_DESCENDENTE : ORDEM_ASCENDENTE;
+    memset(analise, 0, sizeof(AnaliseEntrada));
+
+    // Acima deste número de corridas naturais, a intercalação natural não compensa
+    long limite_corridas = quantidade / ((long)FATOR_CORRIDAS_NATURAIS * tam_memoria);
+    if (limite_corridas < 1 || !usa_naturais) limite_corridas = 1;
+
+    Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pre);
+    Fita *copia = abrir_fita(destino, FITA_ESCRITA, &stats->blocos_escritos_pre);
+    limitar_fita(entrada, quantidade);
+
+    Registro reg;
+    float anterior = 0.0f;
+    float maior = 0.0f; // Maior nota vista até aqui, na ordem pedida
+    int parou_cedo = 0;
+    while (analise->lidos < quantidade && ler_fita(entrada, &reg)) {
+        stats->leituras_pre++;
+        if (analise->lidos == 0) {
+            analise->corridas = 1;
+            analise->corridas_inversas = 1;
+            maior = reg.nota;
+        } else {
+            stats->comparacoes_pre += 3;
+            if (quebra_ordem(anterior, reg.nota, ordem)) analise->corridas++;
+            if (quebra_ordem(anterior, reg.nota, ordem_inversa)) analise->corridas_inversas++;
+            if (quebra_ordem(maior, reg.nota, ordem)) {
+                analise->fora_de_lugar++;
+            } else {
+                maior = reg.nota;
+            }
+        }
+
+        // Enquanto não houve quebra, a cópia já é a saída ordenada
+        if (analise->corridas == 1) {
+            escrever_fita(copia, &reg);
+            stats->escritas_pre++;
+        }
+        anterior = reg.nota;
+        analise->lidos++;
+
+        // Nem ordenada, nem inversa, nem com corridas naturais longas o bastante
+        if (analise->corridas > limite_corridas && analise->corridas_inversas > 1) {
+            parou_cedo = 1;
+            break;
+        }
+    }
+    fechar_fita(copia);
+    fechar_fita(entrada);
+
+    if (parou_cedo) {
+        analise->classe = ENTRADA_ALEATORIA;
+    } else if (analise->corridas <= 1) {
+        analise->classe = ENTRADA_ORDENADA;
+    } else if (analise->corridas_inversas == 1) {
+        analise->classe = ENTRADA_INVERSA;
+    } else if (usa_naturais) {
+        analise->classe = ENTRADA_QUASE_ORDENADA;
+    } else {
+        analise->classe = ENTRADA_ALEATORIA;
+    }
+}
+
+// Grava o grupo de 'tam_grupo' registros de mesma nota que começa no registro 'inicio' da
+// entrada, na ordem original: de trás para a frente a partir da memória, onde foi guardado na
+// leitura reversa, ou relido em ordem direta se não coube nela
+static void gravar_grupo(const char *arquivo, Fita *saida, const Registro *grupo, long tam_grupo,
+                         long inicio, int tam_memoria, Metricas *stats) {
+    if (tam_grupo <= tam_memoria) {
+        for (long i = tam_grupo - 1; i >= 0; i--) escrever_fita(saida, &grupo[i]);
+    } else {
+        Fita *direta = abrir_fita_em(arquivo, FITA_LEITURA, inicio, 0, &stats->blocos_lidos_pos);
+        limitar_fita(direta, tam_grupo);
+        Registro reg;
+        while (ler_fita(direta, &reg)) escrever_fita(saida, &reg);
+        fechar_fita(direta);
+        stats->leituras_pos += tam_grupo;
+    }
+    stats->escritas_pos += tam_grupo;
+}
+
+// Grava em 'destino' os 'quantidade' primeiros registros da entrada do último para o primeiro,
+// lendo o arquivo em blocos no modo reverso. A entrada inversa pode ter notas repetidas: cada
+// grupo de mesma nota é regravado na sua ordem original, para que a inversão seja estável.
+static void inverter_entrada(const char *arquivo, const char *destino, long quantidade, int tam_memoria,
+                             Metricas *stats) {
+    Fita *entrada = abrir_fita_em(arquivo, FITA_LEITURA, quantidade - 1, 1, &stats->blocos_lidos_pos);
+    Fita *saida = abrir_fita(destino, FITA_ESCRITA, &stats->blocos_escritos_pos);
+    limitar_fita(entrada, quantidade);
+    if (tam_memoria < 1) tam_memoria = 1;
+    Registro *grupo = (Registro *)alocar_temporario(tam_memoria * sizeof(Registro));
+    if (!grupo) {
+        perror("Erro ao alocar memória para a inversão");
+        exit(EXIT_FAILURE);
+    }
+
+    Registro reg;
+    long tam_grupo = 0;       // Registros do grupo atual (guardados em 'grupo' até tam_memoria)
+    long inicio = quantidade; // Posição na entrada do último registro lido
+    while (1) {
+        int leu = ler_fita(entrada, &reg);
+        if (tam_grupo > 0 && (!leu || reg.nota != grupo[0].nota)) {
+            gravar_grupo(arquivo, saida, grupo, tam_grupo, inicio, tam_memoria, stats);
+            tam_grupo = 0;
+        }
+        if (!leu) break;
+        stats->leituras_pos++;
+        inicio--;
+        if (tam_grupo < tam_memoria) grupo[tam_grupo] = reg;
+        tam_grupo++;
+    }
+
+    liberar_temporario(grupo);
+    fechar_fita(saida);
+    fechar_fita(entrada);
+}
+
+int ordenar_adaptativo(const char *arquivo, const char *destino, int quantidade, int tam_memoria,
+                       int usa_naturais, int ordem, Metricas *stats) {
+    if (!pre_analise_ativa) return 0;
+
+    AnaliseEntrada analise;
+    Cronometro inicio, fim;
+    double tempo_analise;
+
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "pre-analise");
+    analisar_entrada(arquivo, destino, quantidade, tam_memoria, usa_naturais, ordem, &analise, stats);
+    finalizar_fase(stats);
+    finalizar_tempo(&inicio, &fim, &tempo_analise);
+
+    switch (analise.classe) {
+        case ENTRADA_ORDENADA:
+            // A cópia feita durante a análise já é a saída
+            stats->tempo_execucao_pre = tempo_analise;
+            return 1;
+        case ENTRADA_INVERSA:
+            stats->tempo_execucao_pre = tempo_analise;
+            iniciar_tempo(&inicio);
+            iniciar_fase(stats, "inversao");
+            inverter_entrada(arquivo, destino, analise.lidos, tam_memoria, stats);
+            finalizar_fase(stats);
+            finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+            return 1;
+        case ENTRADA_QUASE_ORDENADA:
+            intercalacao_natural(arquivo, destino, quantidade, analise.corridas, stats, ordem);
+            stats->tempo_execucao_pre += tempo_analise;
+            return 1;
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/ordenacao_amostragem.h"
+#include "../include/intercalacao2f.h"
+#include "../include/ordenacao_interna.h"
+#include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+#ifndef MEMORIA_AMOSTRAGEM
+#define MEMORIA_AMOSTRAGEM 50 // Memória disponível sem --mem, medida em registros (a mesma do quicksort externo)
+#endif
+
+static int memoria_amostragem = MEMORIA_AMOSTRAGEM; // Registros em memória, segundo o plano
+static int limite_baldes = NUM_BALDES;              // Maior número de intervalos por nível
+static Registro *registros_memoria = NULL;          // Baldes que cabem na memória (e a amostra, na distribuição)
+
+// A memória que comporta memoria_amostragem registros comporta bem mais chaves de amostra (a
+// amostra ocupa o buffer dos baldes em memória, livre durante a distribuição); com memória
+// grande, a amostra é limitada (bastam algumas centenas de chaves por separador)
+#define MAX_TAM_AMOSTRA (64 * 1024)
+#define TAM_AMOSTRA_MEMORIA ((long)memoria_amostragem * (long)sizeof(Registro) / (long)sizeof(ChaveIndice))
+#define TAM_AMOSTRA (int)(TAM_AMOSTRA_MEMORIA < MAX_TAM_AMOSTRA ? TAM_AMOSTRA_MEMORIA : MAX_TAM_AMOSTRA)
+
+// Balde de um nível de distribuição: arquivo temporário reservado apenas na primeira escrita
+typedef struct {
+    Fita *fita;        // NULL enquanto o balde está vazio (ou depois de fechado)
+    int arquivo;       // Arquivo temporário (válido se quantidade > 0)
+    long quantidade;   // Registros gravados
+    int constante;     // 1 se todas as notas gravadas são iguais a 'primeira'
+    float primeira;
+} Balde;
+
+// Separadores de um nível. A busca percorre 'arvore' (layout de Eytzinger: filhos de j em 2j
+// e 2j + 1), que para 63 separadores ocupa 256 bytes e fica inteira no cache; a descida
+// troca o desvio condicional por uma soma, sem erros de previsão.
+typedef struct {
+    float arvore[NUM_BALDES];      // Posições 1..k-1
+    float separadores[NUM_BALDES]; // Em ordem; separadores[k-1] repete o último (sentinela)
+    int k;                         // Intervalos (potência de 2)
+    int niveis;                    // log2(k)
+    int igualdade;                 // 1 se cada separador tem também um balde só para as chaves iguais a ele
+} Separadores;
+
+// Chave usada nas comparações: a ordem descendente é tratada como ascendente sobre -nota
+static float chave_amostragem(const Registro *r, int ordem) {
+    return (ordem == ORDEM_ASCENDENTE) ? r->nota : -r->nota;
+}
+
+// Semente do sorteio: cada chamada parte dela, então execuções repetidas (e ordenações
+// sucessivas no mesmo processo) sorteiam a mesma amostra
+#define SEMENTE_AMOSTRA 0x9e3779b97f4a7c15ULL
+
+// Gerador pseudoaleatório xorshift
+static uint64_t proximo_aleatorio(uint64_t *estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *estado = x;
+    return x;
+}
+
+// Sorteia uma posição em cada um de 's' estratos do arquivo aberto em 'fd' e lê só os
+// registros sorteados (um bloco inteiro por amostra leria quase todo o arquivo quando os
+// estratos são menores que o bloco). Retorna o tamanho da amostra.
+static int sortear_amostra(int fd, long quantidade, ChaveIndice *amostra, int ordem, Metricas *m) {
+    uint64_t estado = SEMENTE_AMOSTRA ^ (uint64_t)quantidade;
+    int s = (quantidade < TAM_AMOSTRA) ? (int)quantidade : TAM_AMOSTRA;
+    CabecalhoArquivo cabecalho;
+    if (fd < 0) {
+        perror("Erro ao preparar a amostragem");
+        exit(EXIT_FAILURE);
+    }
+    long base = ler_cabecalho(fd, &cabecalho) ? (long)cabecalho.tam_cabecalho : 0;
+
+    for (int t = 0; t < s; t++) {
+        long ini = quantidade * t / s;
+        long tam = quantidade * (t + 1) / s - ini;
+        long posicao = ini + (long)(proximo_aleatorio(&estado) % (uint64_t)tam);
+        Registro registro;
+        if (pread(fd, &registro, sizeof(Registro), base + posicao * (long)sizeof(Registro)) != (ssize_t)sizeof(Registro)) {
+            perror("Erro ao ler a amostra");
+            exit(EXIT_FAILURE);
+        }
+        registrar_bytes(sizeof(Registro), 0);
+        m->blocos_lidos_pos++;
+        amostra[t].chave = chave_amostragem(&registro, ordem);
+        amostra[t].indice = t;
+    }
+    m->leituras_pos += s;
+
+    return s;
+}
+
+// Preenche a árvore de Eytzinger percorrendo-a em ordem simétrica
+static void montar_arvore(Separadores *sep, int j, int *proximo) {
+    if (j >= sep->k) return;
+    montar_arvore(sep, 2 * j, proximo);
+    sep->arvore[j] = sep->separadores[(*proximo)++];
+    montar_arvore(sep, 2 * j + 1, proximo);
+}
+
+// Escolhe k - 1 separadores igualmente espaçados na amostra ordenada. Os baldes de igualdade
+// só são usados se 'igualdade' for pedido ou se a amostra repetir um separador (chave frequente).
+static void escolher_separadores(Separadores *sep, ChaveIndice *amostra, int s, int k, int igualdade, Metricas *m) {
+    m->comparacoes_pos += ordenar_chaves(amostra, s);
+
+    sep->k = k;
+    sep->niveis = 0;
+    while ((1 << sep->niveis) < k) sep->niveis++;
+    for (int t = 0; t < k - 1; t++) {
+        sep->separadores[t] = amostra[(long)(t + 1) * s / k].chave;
+    }
+    sep->separadores[k - 1] = sep->separadores[k - 2];
+
+    sep->igualdade = igualdade;
+    for (int t = 1; t < k - 1 && !sep->igualdade; t++) {
+        if (sep->separadores[t] == sep->separadores[t - 1]) sep->igualdade = 1;
+    }
+
+    int proximo = 0;
+    montar_arvore(sep, 1, &proximo);
+}
+
+// Balde de uma chave: i, o número de separadores menores que ela. Com baldes de igualdade,
+// 2i para as chaves entre os separadores i - 1 e i e 2i + 1 para as iguais ao separador i;
+// separadores repetidos deixam baldes vazios entre si. Como toda chave da amostra cai em um
+// balde de igualdade, nenhum balde de intervalo recebe a entrada inteira e a recursão sempre
+// progride, mesmo com muitas chaves repetidas.
+static int classificar_chave(const Separadores *sep, float chave) {
+    int j = 1;
+    for (int d = 0; d < sep->niveis; d++) {
+        j = 2 * j + (chave > sep->arvore[j]);
+    }
+    int i = j - sep->k;
+    if (!sep->igualdade) return i;
+    return 2 * i + (chave == sep->separadores[i]);
+}
+
+static void gravar_no_balde(Balde *balde, const Registro *reg, float chave, Metricas *m) {
+    if (!balde->fita) {
+        balde->arquivo = reservar_arquivo_temporario();
+        balde->fita = abrir_fita_temporaria(balde->arquivo, FITA_ESCRITA, &m->blocos_escritos_pos);
+        balde->constante = 1;
+        balde->primeira = chave;
+    } else if (chave != balde->primeira) {
+        balde->constante = 0;
+    }
+    escrever_fita(balde->fita, reg);
+    balde->quantidade++;
+    m->escritas_pos++;
+}
+
+// Sorteia os separadores e distribui os 'quantidade' primeiros registros entre os baldes do
+// nível em uma única passada sequencial. A origem é o arquivo temporário de um balde do nível
+// anterior ou, se 'balde' for -1, o arquivo de entrada do método (lido pelo modo de entrada
+// atual, mapeado ou não).
+// Retorna o número de baldes (k, ou 2k - 1 com baldes de igualdade).
+static int distribuir_em_baldes(const char *arquivo, int balde, long quantidade, Balde *baldes,
+                                int igualdade, Metricas *m, int ordem) {
+    ChaveIndice *amostra = (ChaveIndice *)registros_memoria;
+
+    // Intervalos suficientes para que o balde médio caiba com folga na memória
+    int k = 2;
+    while (2 * k <= limite_baldes && (long)k * memoria_amostragem < 2 * quantidade) k *= 2;
+
+    Separadores sep;
+    int fd = (balde < 0) ? open(arquivo, O_RDONLY) : descritor_arquivo_temporario(balde);
+    if (fd < 0) {
+        perror("Erro ao preparar a amostragem");
+        exit(EXIT_FAILURE);
+    }
+    int s = sortear_amostra(fd, quantidade, amostra, ordem, m);
+    if (balde < 0) close(fd);
+    escolher_separadores(&sep, amostra, s, k, igualdade, m);
+
+    int num_baldes = sep.igualdade ? 2 * k - 1 : k;
+    memset(baldes, 0, num_baldes * sizeof(Balde));
+
+    Fita *entrada = (balde < 0) ? abrir_fita_entrada(arquivo, &m->blocos_lidos_pos)
+                                : abrir_fita_temporaria(balde, FITA_LEITURA, &m->blocos_lidos_pos);
+    limitar_fita(entrada, quantidade);
+    Registro reg;
+    while (ler_fita(entrada, &reg)) {
+        m->leituras_pos++;
+        float chave = chave_amostragem(&reg, ordem);
+        int b = classificar_chave(&sep, chave);
+        m->comparacoes_pos += sep.niveis + 1;
+        gravar_no_balde(&baldes[b], &reg, chave, m);
+    }
+    fechar_fita(entrada);
+
+    for (int b = 0; b < num_baldes; b++) {
+        if (baldes[b].fita) {
+            fechar_fita(baldes[b].fita);
+            baldes[b].fita = NULL;
+        }
+    }
+    return num_baldes;
+}
+
+// Lê os 'quantidade' primeiros registros da fita (que cabem na memória), fecha a fita, ordena
+// os registros e os anexa à saída
+static void ordenar_em_memoria(Fita *leitura, long quantidade, Fita *saida, Metricas *stats, int ordem) {
+    Registro *registros = registros_memoria;
+
+    limitar_fita(leitura, quantidade);
+    int n = ler_registros_fita(leitura, registros, (int)quantidade);
+    fechar_fita(leitura);
+    stats->leituras_pos += n;
+
+    stats->comparacoes_pos += ordenar_registros(registros, n, ordem);
+
+    escrever_registros_fita(saida, registros, n);
+    stats->escritas_pos += n;
+}
+
+// Anexa à saída um balde de chave única, que já está ordenado
+static void copiar_balde(int arquivo, Fita *saida, Metricas *stats) {
+    Fita *leitura = abrir_fita_temporaria(arquivo, FITA_LEITURA, &stats->blocos_lidos_pos);
+    Registro reg;
+    while (ler_fita(leitura, &reg)) {
+        escrever_fita(saida, &reg);
+        stats->leituras_pos++;
+        stats->escritas_pos++;
+    }
+    fechar_fita(leitura);
+}
+
+// Percorre os baldes de um nível em ordem, anexando cada um à saída: baldes de chave única são
+// copiados, os que cabem na memória são ordenados internamente e os demais são distribuídos
+// de novo no nível seguinte. Os arquivos dos baldes são devolvidos à medida que são consumidos
+// e reaproveitados pelos baldes do nível seguinte.
+// Um balde que recebeu toda a entrada do nível (separadores sem baldes de igualdade, todos
+// no topo de uma chave frequente) é redistribuído com os baldes de igualdade.
+static void ordenar_baldes(Balde *baldes, int num_baldes, long quantidade, Fita *saida,
+                           Metricas *stats, int ordem) {
+    for (int b = 0; b < num_baldes; b++) {
+        if (baldes[b].quantidade == 0) continue;
+        int arquivo = baldes[b].arquivo;
+
+        if (baldes[b].constante) {
+            copiar_balde(arquivo, saida, stats);
+            devolver_arquivo_temporario(arquivo);
+        } else if (baldes[b].quantidade <= memoria_amostragem) {
+            Fita *leitura = abrir_fita_temporaria(arquivo, FITA_LEITURA, &stats->blocos_lidos_pos);
+            ordenar_em_memoria(leitura, baldes[b].quantidade, saida, stats, ordem);
+            devolver_arquivo_temporario(arquivo);
+        } else {
+            // Tudo o que o nível seguinte reservar (baldes e fitas) está morto ao fim dele
+            long marca = marcar_arena();
+            Balde *sub = (Balde *)alocar_temporario((2 * limite_baldes - 1) * sizeof(Balde));
+            if (!sub) {
+                perror("Erro ao alocar memória para os baldes");
+                exit(EXIT_FAILURE);
+            }
+            int igualdade = (baldes[b].quantidade == quantidade);
+            int num_sub = distribuir_em_baldes(NULL, arquivo, baldes[b].quantidade, sub, igualdade, stats, ordem);
+            devolver_arquivo_temporario(arquivo); // Já redistribuído: o disco volta antes do nível seguinte
+            ordenar_baldes(sub, num_sub, baldes[b].quantidade, saida, stats, ordem);
+            restaurar_arena(marca);
+        }
+    }
+}
+
+// Plano de memória da amostragem: baldes ordenados em memória (registros e pares de ordenação),
+// ao lado da fita de saída e da de entrada do nível. Na distribuição, cada intervalo pode ter um
+// balde próprio e um de igualdade, com uma fita cada, e os vetores de baldes dos níveis abertos
+// (contados dois níveis). Sem --mem, vale MEMORIA_AMOSTRAGEM e até NUM_BALDES intervalos.
+static void planejar_amostragem(int quantidade, Metricas *stats) {
+    RequisitosMemoria req = {MEMORIA_AMOSTRAGEM, sizeof(Registro) + sizeof(ChaveIndice), 0, 2, 2, 0,
+                             2 * 2 * sizeof(Balde), NUM_BALDES};
+    PlanoMemoria plano;
+    planejar_memoria(&req, quantidade, &plano, stats);
+    memoria_amostragem = plano.memoria;
+    limite_baldes = plano.fan_in;
+}
+
+// Devolve o buffer dos baldes em memória: reservado da arena, não sobrevive à ordenação
+static void liberar_memoria_amostragem(void) {
+    liberar_temporario(registros_memoria);
+    registros_memoria = NULL;
+}
+
+void ordenar_amostragem(const char *arquivo, const char *destino, int quantidade, Metricas *stats, int ordem) {
+    Cronometro inicio, fim;
+
+    // A amostragem sorteia posições: não pode passar do fim do arquivo
+    CabecalhoArquivo c;
+    consultar_binario(arquivo, &c);
+    if (quantidade > c.quantidade) quantidade = (int)c.quantidade;
+    planejar_amostragem(quantidade, stats);
+    registros_memoria = (Registro *)alocar_temporario((memoria_amostragem > 0 ? memoria_amostragem : 1) * sizeof(Registro));
+    if (!registros_memoria) {
+        perror("Erro ao alocar memória para a amostragem");
+        exit(EXIT_FAILURE);
+    }
+    Fita *saida = abrir_fita(destino, FITA_ESCRITA, &stats->blocos_escritos_pos);
+
+    if (quantidade <= memoria_amostragem) {
+        iniciar_tempo(&inicio);
+        iniciar_fase(stats, "memoria");
+        Fita *leitura = abrir_fita(arquivo, FITA_LEITURA, &stats->blocos_lidos_pos);
+        ordenar_em_memoria(leitura, quantidade, saida, stats, ordem);
+        fechar_fita(saida);
+        liberar_memoria_amostragem();
+        finalizar_fase(stats);
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+        return;
+    }
+
+    Balde *baldes = (Balde *)alocar_temporario((2 * limite_baldes - 1) * sizeof(Balde));
+    if (!baldes) {
+        perror("Erro ao alocar memória para os baldes");
+        exit(EXIT_FAILURE);
+    }
+
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "distribuicao");
+    Metricas distribuicao = {0};
+    int num_baldes = distribuir_em_baldes(arquivo, -1, quantidade, baldes, 0, &distribuicao, ordem);
+    stats->leituras_pre += distribuicao.leituras_pos;
+    stats->escritas_pre += distribuicao.escritas_pos;
+    stats->comparacoes_pre += distribuicao.comparacoes_pos;
+    stats->blocos_lidos_pre += distribuicao.blocos_lidos_pos;
+    stats->blocos_escritos_pre += distribuicao.blocos_escritos_pos;
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "baldes");
+    ordenar_baldes(baldes, num_baldes, quantidade, saida, stats, ordem);
+    fechar_fita(saida);
+    finalizar_fase(stats);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+    liberar_temporario(baldes);
+    liberar_memoria_amostragem();
+}
+
+void ordenacao_por_amostragem(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
+    int ordem = ordem_da_situacao(situacao);
+    Cronometro inicio, fim;
+    planejar_amostragem(quantidade, stats);
+
+    // A saída é preparada em um temporário e só vai para o destino no fim
+    char saida[TAM_CAMINHO_TEMPORARIO];
+    int arquivo_saida = preparar_saida(saida);
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): basta copiá-la
+    iniciar_tempo(&inicio);
+    if (copiar_se_ordenado(arquivo, saida, quantidade, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else if (!ordenar_adaptativo(arquivo, saida, quantidade, memoria_amostragem, 1, ordem, stats)) {
+        ordenar_amostragem(arquivo, saida, quantidade, stats, ordem);
+    }
+    marcar_ordenado(saida, ordem);
+    const char *destino = concluir_saida(arquivo_saida, ARQUIVO_SAIDA_AMOSTRAGEM);
+
+    const char *ordem_str = (ordem == ORDEM_ASCENDENTE) ? "Ascendente" : "Descendente";
+    char nome_algoritmo[100];
+    sprintf(nome_algoritmo, "Ordenacao por Amostragem (%s)", ordem_str);
+    log_metricas(nome_algoritmo, quantidade, situacao == 1 ? "1" : situacao == 2 ? "2" : "3", *stats);
+
+    // Imprime os registros ordenados, se solicitado
+    if (imprime == 1) {
+        printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
+        imprimir_binario(destino);
+    }
+}
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/ordenacao_contagem.h"
+#include "../include/ordenacao_amostragem.h"
+#include "../include/intercalacao2f.h"
+#include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+
+#define TAM_BUFFER_ESPALHAMENTO (16 * TAM_BLOCO_PADRAO) // Bytes dos buffers de espalhamento sem --mem (16 blocos de fita)
+#define MAIOR_VALOR_NOTA 1e15 // Acima disso o valor inteiro da nota não cabe com folga em um long
+// Maior valor que o histograma aceita reescalar: abaixo de 2^22, o erro relativo do float da
+// nota (2^-24) não muda o inteiro mais próximo de nota * escala na nova escala
+#define MAIOR_VALOR_REESCALADO (1L << 22)
+
+static long buffer_espalhamento = TAM_BUFFER_ESPALHAMENTO; // Bytes dos buffers, segundo o plano
+static int histograma_cabe = 1; // 0 se o orçamento de memória não comporta o histograma
+
+// Histograma das notas: contagem de cada valor inteiro nota * escala. O vetor é indexado pelo
+// valor módulo MAX_VALORES_NOTA, o que dispensa conhecer a faixa de antemão: enquanto a faixa
+// [menor, maior] tem no máximo MAX_VALORES_NOTA valores, dois valores nunca dividem uma posição.
+typedef struct {
+    int escala;       // As notas são múltiplos de 1 / escala
+    long menor;       // Menor valor encontrado
+    long maior;       // Maior valor encontrado
+    long *contagem;   // MAX_VALORES_NOTA contadores
+} Histograma;
+
+// Posição do valor no vetor de contadores
+static long posicao_valor(long valor) {
+    long p = valor % MAX_VALORES_NOTA;
+    return (p < 0) ? p + MAX_VALORES_NOTA : p;
+}
+
+// Inteiro mais próximo de nota * escala. Na segunda passada as notas já foram validadas pela
+// contagem, e a conversão não tem como falhar.
+static long valor_escalado(float nota, int escala) {
+    double v = (double)nota * escala;
+    return (long)(v < 0 ? v - 0.5 : v + 0.5);
+}
+
+// Converte a nota para o inteiro nota * escala. Retorna 0 se a nota não é um múltiplo exato
+// de 1 / escala (a mesma conversão de ler_nota: mantissa inteira dividida pela escala).
+static int valor_nota(float nota, int escala, long *valor) {
+    double v = (double)nota * escala;
+    if (!(v > -MAIOR_VALOR_NOTA && v < MAIOR_VALOR_NOTA)) return 0;
+    long r = valor_escalado(nota, escala);
+    if ((float)((double)r / escala) != nota) return 0;
+    *valor = r;
+    return 1;
+}
+
+// Passa o histograma para a escala 'nova', múltiplo da atual: cada valor v vira v * fator.
+// Retorna 0 se a faixa reescalada passa de MAX_VALORES_NOTA valores ou se os valores ficam
+// grandes demais para valor_escalado reproduzi-los a partir das notas.
+static int reescalar_histograma(Histograma *h, int nova, long lidos) {
+    long fator = nova / h->escala;
+    h->escala = nova;
+    if (lidos == 0) return 1;
+
+    long modulo = (-h->menor > h->maior) ? -h->menor : h->maior;
+    if ((h->maior - h->menor) * fator >= MAX_VALORES_NOTA || modulo * fator >= MAIOR_VALOR_REESCALADO) return 0;
+
+    // Os contadores da faixa saem para uma cópia (no espaço que o plano reserva para o
+    // espalhamento) e voltam nas posições dos valores reescalados
+    long faixa = h->maior - h->menor + 1;
+    long *copia = (long *)alocar_temporario(faixa * sizeof(long));
+    if (!copia) {
+        perror("Erro ao alocar memória para o histograma");
+        exit(EXIT_FAILURE);
+    }
+    for (long t = 0; t < faixa; t++) {
+        long p = posicao_valor(h->menor + t);
+        copia[t] = h->contagem[p];
+        h->contagem[p] = 0;
+    }
+    for (long t = 0; t < faixa; t++) {
+        if (copia[t] > 0) h->contagem[posicao_valor((h->menor + t) * fator)] = copia[t];
+    }
+    liberar_temporario(copia);
+    h->menor *= fator;
+    h->maior *= fator;
+    return 1;
+}
+
+// Primeira passada: conta as ocorrências de cada valor, começando na escala 1 e passando à
+// menor escala (até MAX_ESCALA_NOTA) em que a nota lida é exata sempre que uma não é.
+// Retorna 0 (histograma inválido) se alguma nota não é exata em nenhuma escala ou se a faixa
+// de valores passa de MAX_VALORES_NOTA.
+static int contar_valores(const char *arquivo, int quantidade, Histograma *h, Metricas *stats) {
+    h->contagem = (long *)alocar_temporario(MAX_VALORES_NOTA * sizeof(long));
+    if (!h->contagem) {
+        perror("Erro ao alocar memória para o histograma");
+        exit(EXIT_FAILURE);
+    }
+    memset(h->contagem, 0, MAX_VALORES_NOTA * sizeof(long));
+
+    h->escala = 1;
+    h->menor = h->maior = 0;
+    Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pre);
+    limitar_fita(entrada, quantidade);
+    Registro reg;
+    long lidos = 0;
+    int valido = 1;
+    while (valido && ler_fita(entrada, &reg)) {
+        stats->leituras_pre++;
+        long valor;
+        if (!valor_nota(reg.nota, h->escala, &valor)) {
+            int nova = h->escala * 10;
+            while (nova <= MAX_ESCALA_NOTA && !valor_nota(reg.nota, nova, &valor)) nova *= 10;
+            if (nova > MAX_ESCALA_NOTA || !reescalar_histograma(h, nova, lidos)) {
+                valido = 0;
+                break;
+            }
+        }
+        if (lidos == 0) {
+            h->menor = h->maior = valor;
+        } else if (valor < h->menor) {
+            h->menor = valor;
+        } else if (valor > h->maior) {
+            h->maior = valor;
+        }
+        if (h->maior - h->menor >= MAX_VALORES_NOTA) {
+            valido = 0;
+            break;
+        }
+        h->contagem[posicao_valor(valor)]++;
+        lidos++;
+    }
+    fechar_fita(entrada);
+    return valido;
+}
+
+// Grava n registros na posição 'destino' do arquivo de saída (após o cabeçalho)
+static void gravar_registros(int fd, const Registro *v, int n, long destino, Metricas *stats) {
+    long bytes = n * (long)sizeof(Registro);
+    long deslocamento = TAM_CABECALHO + destino * (long)sizeof(Registro);
+    long feito = 0;
+    while (feito < bytes) {
+        ssize_t r = pwrite(fd, (const char *)v + feito, bytes - feito, deslocamento + feito);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            perror("Erro ao gravar a saída da contagem");
+            exit(EXIT_FAILURE);
+        }
+        feito += r;
+    }
+    registrar_bytes(0, bytes);
+    stats->blocos_escritos_pos++;
+}
+
+// Segunda passada: relê a entrada e grava cada registro na posição final do seu valor.
+// Cada valor ocupado tem um buffer próprio (a memória de espalhamento dividida entre eles)
+// que é descarregado com uma única escrita na posição corrente do valor; se a entrada inteira
+// cabe nessa memória, os registros são espalhados em memória e gravados de uma vez.
+static void espalhar_registros(const char *arquivo, const char *destino, int quantidade, Histograma *h,
+                               Metricas *stats, int ordem) {
+    long num_valores = h->maior - h->menor + 1;
+    int *indice = (int *)alocar_temporario(num_valores * sizeof(int)); // Buffer de cada valor (-1: vazio)
+    long *proxima = (long *)alocar_temporario(num_valores * sizeof(long));
+    if (!indice || !proxima) {
+        perror("Erro ao alocar memória para o espalhamento");
+        exit(EXIT_FAILURE);
+    }
+
+    // Soma de prefixos na ordem pedida: posição inicial de cada valor ocupado na saída
+    long total = 0;
+    int ocupados = 0;
+    for (long t = 0; t < num_valores; t++) {
+        long valor = (ordem == ORDEM_ASCENDENTE) ? h->menor + t : h->maior - t;
+        long c = h->contagem[posicao_valor(valor)];
+        long k = valor - h->menor;
+        indice[k] = (c > 0) ? ocupados++ : -1;
+        if (c > 0) proxima[indice[k]] = total;
+        total += c;
+    }
+
+    Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pos);
+    limitar_fita(entrada, quantidade);
+    Registro reg;
+
+    if (total * (long)sizeof(Registro) <= buffer_espalhamento) {
+        Registro *saida = (Registro *)alocar_temporario((total > 0 ? total : 1) * sizeof(Registro));
+        if (!saida) {
+            perror("Erro ao alocar memória para o espalhamento");
+            exit(EXIT_FAILURE);
+        }
+        while (ler_fita(entrada, &reg)) {
+            long valor = valor_escalado(reg.nota, h->escala);
+            saida[proxima[indice[valor - h->menor]]++] = reg;
+            stats->leituras_pos++;
+        }
+        Fita *arquivo_saida = abrir_fita(destino, FITA_ESCRITA, &stats->blocos_escritos_pos);
+        escrever_registros_fita(arquivo_saida, saida, (int)total);
+        fechar_fita(arquivo_saida);
+        stats->escritas_pos += total;
+        liberar_temporario(saida);
+    } else {
+        int capacidade = (int)(buffer_espalhamento / (long)sizeof(Registro) / ocupados);
+        if (capacidade < 1) capacidade = 1;
+        Registro *buffers = (Registro *)alocar_temporario((size_t)ocupados * capacidade * sizeof(Registro));
+        int *cheios = (int *)alocar_temporario(ocupados * sizeof(int));
+        int fd = open(destino, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (!buffers || !cheios || fd < 0) {
+            perror("Erro ao preparar o espalhamento");
+            exit(EXIT_FAILURE);
+        }
+        memset(cheios, 0, ocupados * sizeof(int));
+
+        CabecalhoArquivo cabecalho;
+        iniciar_cabecalho(&cabecalho);
+        while (ler_fita(entrada, &reg)) {
+            long valor = valor_escalado(reg.nota, h->escala);
+            int b = indice[valor - h->menor];
+            Registro *buffer = &buffers[(size_t)b * capacidade];
+            buffer[cheios[b]++] = reg;
+            stats->leituras_pos++;
+            if (cheios[b] == capacidade) {
+                cabecalho.soma += soma_registros(buffer, capacidade);
+                gravar_registros(fd, buffer, capacidade, proxima[b], stats);
+                proxima[b] += capacidade;
+                cheios[b] = 0;
+            }
+        }
+        for (int b = 0; b < ocupados; b++) {
+            if (cheios[b] == 0) continue;
+            Registro *buffer = &buffers[(size_t)b * capacidade];
+            cabecalho.soma += soma_registros(buffer, cheios[b]);
+            gravar_registros(fd, buffer, cheios[b], proxima[b], stats);
+        }
+        stats->escritas_pos += total;
+
+        cabecalho.quantidade = total;
+        escrever_cabecalho(fd, &cabecalho);
+        close(fd);
+        liberar_temporario(cheios);
+        liberar_temporario(buffers);
+    }
+
+    fechar_fita(entrada);
+    liberar_temporario(proxima);
+    liberar_temporario(indice);
+}
+
+// Plano de memória: buffers de espalhamento (em registros) além do histograma e dos vetores
+// por valor, de tamanho fixo; no espalhamento ficam abertas a entrada e, se a saída cabe
+// na memória, a fita de saída. Um orçamento menor que o histograma fica com a amostragem.
+static void planejar_contagem(int quantidade, Metricas *stats) {
+    RequisitosMemoria req = {TAM_BUFFER_ESPALHAMENTO / (int)sizeof(Registro), sizeof(Registro),
+                             MAX_VALORES_NOTA * (long)(2 * sizeof(long) + sizeof(int)), 2, 0, 0, 0, 0};
+    PlanoMemoria plano;
+    planejar_memoria(&req, quantidade, &plano, stats);
+    buffer_espalhamento = (long)plano.memoria * (long)sizeof(Registro);
+    histograma_cabe = orcamento_memoria() <= 0 || plano.bytes <= orcamento_memoria();
+}
+
+// Ordenação completa por contagem, gravando 'destino'. Retorna 0, sem gravar nada, se as
+// notas não cabem no domínio tratado (a passada de contagem é o pré-processamento) ou se o
+// histograma não cabe no orçamento de memória.
+static int ordenar_contagem(const char *arquivo, const char *destino, int quantidade, Metricas *stats, int ordem) {
+    Cronometro inicio, fim;
+    Histograma h;
+    if (!histograma_cabe) return 0;
+
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "histograma");
+    int valido = contar_valores(arquivo, quantidade, &h, stats);
+    finalizar_fase(stats);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+    if (valido) {
+        iniciar_tempo(&inicio);
+        iniciar_fase(stats, "espalhamento");
+        espalhar_registros(arquivo, destino, quantidade, &h, stats, ordem);
+        finalizar_fase(stats);
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+    }
+    liberar_temporario(h.contagem);
+    return valido;
+}
+
+void ordenacao_por_contagem(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
+    int ordem = ordem_da_situacao(situacao);
+    Cronometro inicio, fim;
+    planejar_contagem(quantidade, stats);
+
+    // A saída é preparada em um temporário e só vai para o destino no fim
+    char saida[TAM_CAMINHO_TEMPORARIO];
+    int arquivo_saida = preparar_saida(saida);
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): basta copiá-la.
+    // Na pré-análise, só as entradas ordenadas ou inversas interessam: a intercalação
+    // natural não vence as duas passadas da contagem.
+    iniciar_tempo(&inicio);
+    if (copiar_se_ordenado(arquivo, saida, quantidade, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else if (!ordenar_adaptativo(arquivo, saida, quantidade, 1, 0, ordem, stats) &&
+               !ordenar_contagem(arquivo, saida, quantidade, stats, ordem)) {
+        printf(histograma_cabe ? "Notas fora do domínio tratado pela contagem: usando a ordenação por amostragem.\n"
+                               : "Histograma da contagem maior que o orçamento de memória: usando a ordenação por amostragem.\n");
+        double tempo_contagem = stats->tempo_execucao_pre;
+        ordenar_amostragem(arquivo, saida, quantidade, stats, ordem);
+        stats->tempo_execucao_pre += tempo_contagem;
+    }
+    marcar_ordenado(saida, ordem);
+    const char *destino = concluir_saida(arquivo_saida, ARQUIVO_SAIDA_CONTAGEM);
+
+    const char *ordem_str = (ordem == ORDEM_ASCENDENTE) ? "Ascendente" : "Descendente";
+    char nome_algoritmo[100];
+    sprintf(nome_algoritmo, "Ordenacao por Contagem (%s)", ordem_str);
+    log_metricas(nome_algoritmo, quantidade, situacao == 1 ? "1" : situacao == 2 ? "2" : "3", *stats);
+
+    // Imprime os registros ordenados, se solicitado
+    if (imprime == 1) {
+        printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
+        imprimir_binario(destino);
+    }
+}
@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/ordenacao_etiquetas.h"
+#include "../include/intercalacao2f.h"
+#include "../include/ordenacao_interna.h"
+#include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+#ifndef MAX_MEMORIA_ETIQUETAS
+#define MAX_MEMORIA_ETIQUETAS 20 // Memória disponível sem --mem, medida em registros (cabem ~4 etiquetas por registro)
+#endif
+
+// Abre num_fitas fitas de etiquetas sobre os arquivos temporários indicados, no modo pedido
+static void abrir_fitas_etiquetas(Fita **fitas, const int *arquivos, int num_fitas, int modo, long *contador_blocos) {
+    for (int i = 0; i < num_fitas; i++) {
+        fitas[i] = abrir_fita_itens(arquivos[i], modo, (int)sizeof(NotaPosicao), contador_blocos);
+    }
+}
+
+static void fechar_fitas_etiquetas(Fita **fitas, int num_fitas) {
+    for (int i = 0; i < num_fitas; i++) {
+        fechar_fita(fitas[i]);
+        fitas[i] = NULL;
+    }
+}
+
+// Retorna 1 se a etiqueta 'a' vem antes de 'b': pela nota na ordem pedida e, em caso de empate,
+// pela posição original (a ordem fica total, o que mantém o resultado estável)
+static int precede_etiqueta(const NotaPosicao *a, const NotaPosicao *b, int ordem) {
+    if (a->nota != b->nota) {
+        return (ordem == ORDEM_ASCENDENTE) ? a->nota < b->nota : a->nota > b->nota;
+    }
+    return a->posicao < b->posicao;
+}
+
+// Gera as corridas iniciais: lê a entrada em blocos de 'tam_memoria' registros, guarda
+// apenas a etiqueta de cada um, ordena as etiquetas e as grava alternadamente nas fitas.
+// Retorna o número de corridas geradas.
+static int gerar_corridas_etiquetas(Fita *entrada, int quantidade, Fita **fitas, int num_fitas,
+                                    int tam_memoria, Metricas *stats, int ordem) {
+    NotaPosicao *etiquetas = (NotaPosicao *)alocar_temporario(tam_memoria * sizeof(NotaPosicao));
+    ChaveIndice *chaves = (ChaveIndice *)alocar_temporario(tam_memoria * sizeof(ChaveIndice));
+    if (!etiquetas || !chaves) {
+        perror("Erro ao alocar memória para as etiquetas");
+        exit(EXIT_FAILURE);
+    }
+
+    Registro reg;
+    int lidos = 0;
+    int num_corridas = 0;
+    while (lidos < quantidade) {
+        int n = 0;
+        while (n < tam_memoria && lidos + n < quantidade && ler_fita(entrada, &reg)) {
+            etiquetas[n].nota = reg.nota;
+            etiquetas[n].posicao = lidos + n;
+            chaves[n].chave = (ordem == ORDEM_DESCENDENTE) ? -reg.nota : reg.nota;
+            chaves[n].indice = n;
+            n++;
+        }
+        if (n == 0) break;
+        lidos += n;
+        stats->leituras_pre += n;
+
+        // O desempate pelo índice do introsort preserva a ordem das posições
+        stats->comparacoes_pre += ordenar_chaves(chaves, n);
+
+        Fita *destino = fitas[num_corridas % num_fitas];
+        for (int k = 0; k < n; k++) {
+            escrever_item_fita(destino, &etiquetas[chaves[k].indice]);
+        }
+        stats->escritas_pre += n;
+        registrar_tamanho_corrida(stats, n);
+        num_corridas++;
+    }
+
+    liberar_temporario(chaves);
+    liberar_temporario(etiquetas);
+    return num_corridas;
+}
+
+// Realiza uma passada de intercalação das etiquetas: intercala uma corrida de cada fita de
+// entrada por vez e grava o resultado alternadamente nas fitas de saída.
+// Retorna o número de corridas gravadas.
+static int intercalar_etiquetas(Fita **entradas, Fita **saidas, int num_fitas,
+                                Metricas *stats, int ordem) {
+    NotaPosicao *atual = (NotaPosicao *)alocar_temporario(num_fitas * sizeof(NotaPosicao));
+    int *tem_etiqueta = (int *)alocar_temporario(num_fitas * sizeof(int));
+    long *desempate = (long *)alocar_temporario(num_fitas * sizeof(long));
+    ArvorePerdedores *arv = criar_arvore_perdedores(num_fitas, ordem, &stats->comparacoes_pos);
+    if (!atual || !tem_etiqueta || !desempate || !arv) {
+        perror("Erro ao alocar memória para a intercalação das etiquetas");
+        exit(EXIT_FAILURE);
+    }
+    arv->desempate = desempate;
+
+    int restantes = 0;
+    for (int i = 0; i < num_fitas; i++) {
+        tem_etiqueta[i] = ler_item_fita(entradas[i], &atual[i]);
+        stats->leituras_pos += tem_etiqueta[i];
+        restantes += tem_etiqueta[i];
+    }
+
+    int corridas = 0;
+    while (restantes > 0) {
+        for (int i = 0; i < num_fitas; i++) {
+            arv->chaves[i] = atual[i].nota;
+            desempate[i] = atual[i].posicao;
+            arv->ativa[i] = tem_etiqueta[i];
+        }
+        construir_arvore_perdedores(arv);
+
+        Fita *saida = saidas[corridas % num_fitas];
+        int escolhida;
+        while ((escolhida = vencedora_arvore_perdedores(arv)) >= 0) {
+            escrever_item_fita(saida, &atual[escolhida]);
+            stats->escritas_pos++;
+
+            // A corrida da fita termina no fim do arquivo ou numa quebra da ordem (nota, posição)
+            NotaPosicao ultima = atual[escolhida];
+            int ativa = tem_etiqueta[escolhida] = ler_item_fita(entradas[escolhida], &atual[escolhida]);
+            if (ativa) {
+                stats->leituras_pos++;
+                stats->comparacoes_pos++;
+                ativa = !precede_etiqueta(&atual[escolhida], &ultima, ordem);
+            } else {
+                restantes--;
+            }
+            desempate[escolhida] = atual[escolhida].posicao;
+            atualizar_arvore_perdedores(arv, escolhida, atual[escolhida].nota, ativa);
+        }
+        corridas++;
+    }
+
+    liberar_arvore_perdedores(arv);
+    liberar_temporario(desempate);
+    liberar_temporario(tem_etiqueta);
+    liberar_temporario(atual);
+    return corridas;
+}
+
+// Um trecho de posições próximas só é lido de uma vez se pelo menos uma em cada
+// FATOR_TRECHO_DENSO posições do trecho pertence ao lote
+#define FATOR_TRECHO_DENSO 2
+
+// Lê 'n' registros consecutivos a partir da posição indicada
+static void ler_registros_em(int fd, long base, long posicao, Registro *destino, long n, Metricas *stats) {
+    long bytes = n * (long)sizeof(Registro);
+    if (pread(fd, destino, bytes, base + posicao * (long)sizeof(Registro)) != bytes) {
+        perror("Erro ao ler o registro de uma etiqueta");
+        exit(EXIT_FAILURE);
+    }
+    registrar_bytes(bytes, 0);
+    stats->blocos_lidos_pos++;
+}
+
+// Busca com pread os registros do lote, já ordenado pela posição: cada registro é lido
+// sozinho, exceto onde as posições são densas, onde o trecho que as cobre é lido de uma vez
+static void buscar_lote(int fd, long base, const ChaveRadix *posicoes, int n, Registro *lote,
+                        Registro *janela, long tam_janela, Metricas *stats) {
+    for (int k = 0; k < n; ) {
+        // Estende o trecho enquanto ele cabe na janela e continua denso
+        long inicio = posicoes[k].chave;
+        int fim = k + 1;
+        while (fim < n) {
+            long extensao = (long)posicoes[fim].chave - inicio + 1;
+            if (extensao > tam_janela || extensao > (long)FATOR_TRECHO_DENSO * (fim - k + 1)) break;
+            fim++;
+        }
+
+        if (fim - k == 1) {
+            ler_registros_em(fd, base, inicio, &lote[posicoes[k].indice], 1, stats);
+        } else {
+            ler_registros_em(fd, base, inicio, janela, (long)posicoes[fim - 1].chave - inicio + 1, stats);
+            for (int j = k; j < fim; j++) {
+                lote[posicoes[j].indice] = janela[posicoes[j].chave - inicio];
+            }
+        }
+        k = fim;
+    }
+}
+
+// Copia do mapeamento da entrada (--mmap) os registros do lote, em ordem crescente de posição;
+// conta um bloco lido por bloco do arquivo tocado
+static void buscar_lote_mapeado(const ArquivoMapeado *mapa, const ChaveRadix *posicoes, int n, Registro *lote,
+                                Metricas *stats) {
+    long por_bloco = registros_por_bloco();
+    long bloco_anterior = -1;
+    for (int k = 0; k < n; k++) {
+        long posicao = posicoes[k].chave;
+        lote[posicoes[k].indice] = mapa->registros[posicao];
+        if (posicao / por_bloco != bloco_anterior) {
+            bloco_anterior = posicao / por_bloco;
+            stats->blocos_lidos_pos++;
+        }
+    }
+    registrar_bytes(n * (long)sizeof(Registro), 0);
+}
+
+// Fase de montagem: percorre as etiquetas ordenadas em lotes de 'tam_lote'; cada lote é
+// reordenado pela posição dos registros, que são então buscados em ordem crescente de
+// deslocamento (com pread ou, em --mmap, direto do mapeamento) e gravados na saída na
+// ordem das etiquetas
+static void montar_saida(Fita *etiquetas, const char *arquivo, Fita *saida, int tam_lote, long tam_janela,
+                         Metricas *stats) {
+    const ArquivoMapeado *mapa = entrada_mapeada_ativa() ? mapear_binario(arquivo) : NULL;
+    int fd = -1;
+    long base = 0;
+    Registro *janela = NULL;
+    if (!mapa) {
+        fd = open(arquivo, O_RDONLY);
+        CabecalhoArquivo cabecalho;
+        if (fd >= 0 && ler_cabecalho(fd, &cabecalho)) base = (long)cabecalho.tam_cabecalho;
+    }
+    NotaPosicao *lote_etiquetas = (NotaPosicao *)alocar_temporario(tam_lote * sizeof(NotaPosicao));
+    Registro *lote = (Registro *)alocar_temporario(tam_lote * sizeof(Registro));
+    ChaveRadix *posicoes = (ChaveRadix *)alocar_temporario(2 * (size_t)tam_lote * sizeof(ChaveRadix));
+    if (!mapa) janela = (Registro *)alocar_temporario(tam_janela * sizeof(Registro));
+    if ((!mapa && (fd < 0 || !janela)) || !lote_etiquetas || !lote || !posicoes) {
+        perror("Erro ao preparar a montagem da saída");
+        exit(EXIT_FAILURE);
+    }
+
+    while (1) {
+        int n = 0;
+        while (n < tam_lote && ler_item_fita(etiquetas, &lote_etiquetas[n])) {
+            posicoes[n].chave = (uint32_t)lote_etiquetas[n].posicao;
+            posicoes[n].indice = n;
+            n++;
+        }
+        if (n == 0) break;
+
+        // Ordena o lote pela posição no arquivo (radix: as posições já são inteiros)
+        ordenar_chaves_radix(posicoes, posicoes + n, n);
+        if (mapa) {
+            buscar_lote_mapeado(mapa, posicoes, n, lote, stats);
+        } else {
+            buscar_lote(fd, base, posicoes, n, lote, janela, tam_janela, stats);
+        }
+        stats->leituras_pos += n;
+
+        escrever_registros_fita(saida, lote, n);
+        stats->escritas_pos += n;
+    }
+
+    if (fd >= 0) close(fd);
+    liberar_temporario(janela);
+    liberar_temporario(posicoes);
+    liberar_temporario(lote);
+    liberar_temporario(lote_etiquetas);
+}
+
+// Plano de memória das etiquetas: a área de trabalho guarda etiquetas e seus pares de ordenação
+// (sem --mem, o equivalente a MAX_MEMORIA_ETIQUETAS registros) ao lado da entrada e de uma fita
+// de corridas por via; na intercalação, cada via tem uma fita de entrada, uma de saída, a
+// etiqueta corrente com seu estado e desempate, e sua folha na árvore
+static void planejar_etiquetas(int quantidade, PlanoMemoria *plano, Metricas *stats) {
+    long bytes_etiqueta = sizeof(NotaPosicao) + sizeof(ChaveIndice);
+    RequisitosMemoria req = {MAX_MEMORIA_ETIQUETAS * (int)sizeof(Registro) / (int)bytes_etiqueta, bytes_etiqueta,
+                             0, 1, 1, 2, sizeof(NotaPosicao) + sizeof(int) + sizeof(long) + BYTES_FOLHA_ARVORE,
+                             FAN_IN_MAXIMO};
+    planejar_memoria(&req, quantidade, plano, stats);
+}
+
+// Ordenação completa das etiquetas e montagem de 'destino'
+static void ordenar_etiquetas(const char *arquivo, const char *destino, int quantidade, Metricas *stats, int ordem) {
+    Fita *entradas[FAN_IN_MAXIMO];
+    Fita *saidas[FAN_IN_MAXIMO];
+    int arquivos[2 * FAN_IN_MAXIMO]; // Arquivos temporários das 2F fitas de etiquetas
+    Cronometro inicio, fim;
+
+    // A mesma memória que comporta MAX_MEMORIA_ETIQUETAS registros comporta bem mais etiquetas
+    // (cada uma ocupa a etiqueta em si e seu par de ordenação)
+    PlanoMemoria plano;
+    planejar_etiquetas(quantidade, &plano, stats);
+    int tam_memoria = plano.memoria;
+    int num_fitas = calcular_fan_in(plano.fan_in, (quantidade + tam_memoria - 1) / tam_memoria);
+    for (int i = 0; i < 2 * num_fitas; i++) arquivos[i] = reservar_arquivo_temporario();
+
+    // Na montagem, as fitas das corridas e da intercalação já foram fechadas: toda a memória do
+    // plano, menos a fita das etiquetas ordenadas, a da saída e a janela de leitura (dispensada
+    // com --mmap), guarda lotes de registros com suas etiquetas e posições
+    long tam_janela = entrada_mapeada_ativa() ? 0 : registros_por_bloco();
+    long bytes_lote = sizeof(Registro) + sizeof(NotaPosicao) + 2 * sizeof(ChaveRadix);
+    long livres = plano.bytes - FOLGA_RESERVAS_PLANO - bytes_fita(sizeof(NotaPosicao)) -
+                  bytes_fita(sizeof(Registro)) - tam_janela * (long)sizeof(Registro);
+    long lote = livres / bytes_lote;
+    if (lote > quantidade) lote = quantidade;
+    if (lote < 1) lote = 1;
+    int tam_lote = (int)lote;
+    long marca = marcar_arena(); // Restaurada ao fim de cada fase
+
+    // Pré-processamento: extrai as etiquetas e gera as corridas iniciais no primeiro grupo de fitas
+    iniciar_tempo(&inicio);
+    iniciar_fase(stats, "corridas");
+    Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pre);
+    abrir_fitas_etiquetas(entradas, arquivos, num_fitas, FITA_ESCRITA, &stats->blocos_escritos_pre);
+    int num_corridas = gerar_corridas_etiquetas(entrada, quantidade, entradas, num_fitas,
+                                                tam_memoria, stats, ordem);
+    fechar_fita(entrada);
+    fechar_fitas_etiquetas(entradas, num_fitas);
+    restaurar_arena(marca);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+    // Intercalação das etiquetas em 2F fitas, alternando os grupos de entrada e saída
+    iniciar_tempo(&inicio);
+    int grupo_entrada = 0;
+    for (int passada = 1; num_corridas > 1; passada++) {
+        char nome_fase[TAM_NOME_FASE];
+        snprintf(nome_fase, sizeof(nome_fase), "passada %d", passada);
+        iniciar_fase(stats, nome_fase);
+        int grupo_saida = num_fitas - grupo_entrada;
+        abrir_fitas_etiquetas(entradas, arquivos + grupo_entrada, num_fitas, FITA_LEITURA, &stats->blocos_lidos_pos);
+        abrir_fitas_etiquetas(saidas, arquivos + grupo_saida, num_fitas, FITA_ESCRITA, &stats->blocos_escritos_pos);
+        num_corridas = intercalar_etiquetas(entradas, saidas, num_fitas, stats, ordem);
+        fechar_fitas_etiquetas(entradas, num_fitas);
+        fechar_fitas_etiquetas(saidas, num_fitas);
+        restaurar_arena(marca);
+        grupo_entrada = grupo_saida;
+    }
+
+    // Montagem: aplica a permutação das etiquetas ordenadas aos registros completos
+    iniciar_fase(stats, "montagem");
+    Fita *ordenadas = abrir_fita_itens(arquivos[grupo_entrada], FITA_LEITURA, (int)sizeof(NotaPosicao), &stats->blocos_lidos_pos);
+    Fita *saida = abrir_fita(destino, FITA_ESCRITA, &stats->blocos_escritos_pos);
+    montar_saida(ordenadas, arquivo, saida, tam_lote, tam_janela, stats);
+    fechar_fita(ordenadas);
+    fechar_fita(saida);
+    restaurar_arena(marca);
+    finalizar_fase(stats);
+    finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+
+    for (int i = 0; i < 2 * num_fitas; i++) {
+        devolver_arquivo_temporario(arquivos[i]);
+    }
+}
+
+void ordenacao_por_etiquetas(const char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
+    int ordem = ordem_da_situacao(situacao);
+    Cronometro inicio, fim;
+    PlanoMemoria plano;
+    planejar_etiquetas(quantidade, &plano, stats);
+
+    // A saída é preparada em um temporário e só vai para o destino no fim
+    char saida[TAM_CAMINHO_TEMPORARIO];
+    int arquivo_saida = preparar_saida(saida);
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): basta copiá-la
+    iniciar_tempo(&inicio);
+    if (copiar_se_ordenado(arquivo, saida, quantidade, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else if (!ordenar_adaptativo(arquivo, saida, quantidade, plano.memoria, 1, ordem, stats)) {
+        ordenar_etiquetas(arquivo, saida, quantidade, stats, ordem);
+    }
+    marcar_ordenado(saida, ordem);
+    const char *destino = concluir_saida(arquivo_saida, ARQUIVO_SAIDA_ETIQUETAS);
+
+    const char *ordem_str = (ordem == ORDEM_ASCENDENTE) ? "Ascendente" : "Descendente";
+    char nome_algoritmo[100];
+    sprintf(nome_algoritmo, "Ordenacao por Etiquetas (%s)", ordem_str);
+    log_metricas(nome_algoritmo, quantidade, situacao == 1 ? "1" : situacao == 2 ? "2" : "3", *stats);
+
+    // Imprime os registros ordenados, se solicitado
+    if (imprime == 1) {
+        printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
+        imprimir_binario(destino);
+    }
+}
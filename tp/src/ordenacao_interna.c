@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/ordenacao_interna.h"
+#include "../include/intercalacao2f.h"
+#include "../include/arena.h"
+
+#define LIMITE_INSERCAO 16 // Intervalos menores que isso são ordenados por inserção
+
+// Retorna 1 se o par 'a' vem antes do par 'b'
+static inline int menor_par(const ChaveIndice *a, const ChaveIndice *b) {
+    if (a->chave != b->chave) return a->chave < b->chave;
+    return a->indice < b->indice;
+}
+
+static inline void trocar_pares(ChaveIndice *a, ChaveIndice *b) {
+    ChaveIndice temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+// Ordenação por inserção para intervalos pequenos
+static void insercao(ChaveIndice *v, int n, long *comparacoes) {
+    for (int i = 1; i < n; i++) {
+        ChaveIndice x = v[i];
+        int j = i - 1;
+        while (j >= 0) {
+            (*comparacoes)++;
+            if (!menor_par(&x, &v[j])) break;
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+// Desce um elemento no max-heap usado pelo heapsort de contingência
+static void descer_heap_pares(ChaveIndice *v, int i, int n, long *comparacoes) {
+    while (1) {
+        int maior = i;
+        int esq = 2 * i + 1;
+        int dir = esq + 1;
+        if (esq < n) {
+            (*comparacoes)++;
+            if (menor_par(&v[maior], &v[esq])) maior = esq;
+        }
+        if (dir < n) {
+            (*comparacoes)++;
+            if (menor_par(&v[maior], &v[dir])) maior = dir;
+        }
+        if (maior == i) return;
+        trocar_pares(&v[i], &v[maior]);
+        i = maior;
+    }
+}
+
+// Heapsort: usado quando o quicksort excede a profundidade limite
+static void heapsort_pares(ChaveIndice *v, int n, long *comparacoes) {
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        descer_heap_pares(v, i, n, comparacoes);
+    }
+    for (int fim = n - 1; fim > 0; fim--) {
+        trocar_pares(&v[0], &v[fim]);
+        descer_heap_pares(v, 0, fim, comparacoes);
+    }
+}
+
+// Coloca a mediana de v[0], v[n/2] e v[n-1] em v[0], para servir de pivô
+static void mediana_de_tres(ChaveIndice *v, int n, long *comparacoes) {
+    int meio = n / 2;
+    *comparacoes += 3;
+    if (menor_par(&v[meio], &v[0])) trocar_pares(&v[meio], &v[0]);
+    if (menor_par(&v[n - 1], &v[meio])) trocar_pares(&v[n - 1], &v[meio]);
+    if (menor_par(&v[meio], &v[0])) trocar_pares(&v[meio], &v[0]);
+    trocar_pares(&v[0], &v[meio]);
+}
+
+static void introsort(ChaveIndice *v, int n, int profundidade, long *comparacoes) {
+    while (n > LIMITE_INSERCAO) {
+        if (profundidade == 0) {
+            heapsort_pares(v, n, comparacoes);
+            return;
+        }
+        profundidade--;
+
+        // Partição de Hoare com o pivô em v[0]; os pares são distintos (desempate pelo índice)
+        mediana_de_tres(v, n, comparacoes);
+        ChaveIndice pivo = v[0];
+        int i = 0, j = n;
+        while (1) {
+            do { i++; (*comparacoes)++; } while (i < n && menor_par(&v[i], &pivo));
+            do { j--; (*comparacoes)++; } while (menor_par(&pivo, &v[j]));
+            if (i >= j) break;
+            trocar_pares(&v[i], &v[j]);
+        }
+        trocar_pares(&v[0], &v[j]);
+
+        // Recursão no lado menor, laço no maior (pilha limitada a O(log n))
+        if (j < n - j - 1) {
+            introsort(v, j, profundidade, comparacoes);
+            v += j + 1;
+            n -= j + 1;
+        } else {
+            introsort(v + j + 1, n - j - 1, profundidade, comparacoes);
+            n = j;
+        }
+    }
+    insercao(v, n, comparacoes);
+}
+
+long ordenar_chaves(ChaveIndice *v, int n) {
+    long comparacoes = 0;
+    int profundidade = 0;
+    for (int m = n; m > 1; m >>= 1) {
+        profundidade += 2;
+    }
+    introsort(v, n, profundidade, &comparacoes);
+    return comparacoes;
+}
+
+void aplicar_permutacao(Registro *registros, ChaveIndice *v, int n) {
+    for (int inicio = 0; inicio < n; inicio++) {
+        if (v[inicio].indice == inicio) continue;
+
+        // Percorre o ciclo que começa em 'inicio', puxando cada registro para o seu destino
+        Registro temp = registros[inicio];
+        int atual = inicio;
+        while (v[atual].indice != inicio) {
+            int origem = v[atual].indice;
+            registros[atual] = registros[origem];
+            v[atual].indice = atual; // Marca a posição como resolvida
+            atual = origem;
+        }
+        registros[atual] = temp;
+        v[atual].indice = atual;
+    }
+}
+
+long ordenar_registros(Registro *registros, int n, int ordem) {
+    if (n <= 1) return 0;
+
+    ChaveIndice *v = (ChaveIndice *)alocar_temporario(n * sizeof(ChaveIndice));
+    if (!v) {
+        perror("Erro ao alocar memória para ordenação interna");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        v[i].chave = (ordem == ORDEM_ASCENDENTE) ? registros[i].nota : -registros[i].nota;
+        v[i].indice = i;
+    }
+
+    long comparacoes = ordenar_chaves(v, n);
+    aplicar_permutacao(registros, v, n);
+
+    liberar_temporario(v);
+    return comparacoes;
+}
+
+uint32_t codificar_nota(float nota, int ordem) {
+    uint32_t bits;
+    if (nota == 0.0f) nota = 0.0f; // -0.0 e +0.0 são iguais na comparação de floats
+    memcpy(&bits, &nota, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    return (ordem == ORDEM_ASCENDENTE) ? bits : ~bits;
+}
+
+void ordenar_chaves_radix(ChaveRadix *v, ChaveRadix *aux, int n) {
+    int contagem[4][256];
+    memset(contagem, 0, sizeof(contagem));
+
+    // Uma única leitura monta os histogramas dos quatro bytes
+    for (int i = 0; i < n; i++) {
+        uint32_t c = v[i].chave;
+        contagem[0][c & 0xFF]++;
+        contagem[1][(c >> 8) & 0xFF]++;
+        contagem[2][(c >> 16) & 0xFF]++;
+        contagem[3][c >> 24]++;
+    }
+
+    ChaveRadix *origem = v;
+    ChaveRadix *destino = aux;
+    for (int passada = 0; passada < 4; passada++) {
+        int deslocamento = passada * 8;
+        int *cont = contagem[passada];
+
+        // Todos os pares têm o mesmo byte nesta posição: a passada não mudaria nada
+        if (n == 0 || cont[(origem[0].chave >> deslocamento) & 0xFF] == n) continue;
+
+        // Soma de prefixos: cont[b] passa a ser a primeira posição de saída do byte b
+        int total = 0;
+        for (int b = 0; b < 256; b++) {
+            int c = cont[b];
+            cont[b] = total;
+            total += c;
+        }
+
+        // Espalhamento estável
+        for (int i = 0; i < n; i++) {
+            destino[cont[(origem[i].chave >> deslocamento) & 0xFF]++] = origem[i];
+        }
+
+        ChaveRadix *temp = origem;
+        origem = destino;
+        destino = temp;
+    }
+
+    if (origem != v) {
+        memcpy(v, origem, n * sizeof(ChaveRadix));
+    }
+}
+
+void ordenar_indices_radix(const Registro *registros, ChaveRadix *v, int n, int ordem) {
+    for (int i = 0; i < n; i++) {
+        v[i].chave = codificar_nota(registros[i].nota, ordem);
+        v[i].indice = i;
+    }
+    ordenar_chaves_radix(v, v + n, n);
+}
+
+void ordenar_registros_radix(Registro *registros, int n, int ordem) {
+    if (n <= 1) return;
+
+    ChaveRadix *v = (ChaveRadix *)alocar_temporario(2 * (size_t)n * sizeof(ChaveRadix));
+    if (!v) {
+        perror("Erro ao alocar memória para ordenação interna");
+        exit(EXIT_FAILURE);
+    }
+
+    ordenar_indices_radix(registros, v, n, ordem);
+
+    // Reaproveita a aplicação da permutação do introsort: os pares têm o mesmo formato de índice
+    ChaveIndice *perm = (ChaveIndice *)(v + n);
+    for (int i = 0; i < n; i++) {
+        perm[i].indice = v[i].indice;
+    }
+    aplicar_permutacao(registros, perm, n);
+
+    liberar_temporario(v);
+}
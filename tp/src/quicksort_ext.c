@@ -2,342 +2,372 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../include/quicksort_ext.h"
+#include "../include/intercalacao2f.h"
+#include "../include/ordenacao_interna.h"
+#include "../include/fita.h"
+#include "../include/ordenacao_adaptativa.h"
+#include "../include/memoria.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
 
-#define MEMORIA_INTERNA 50  // Quantidade máxima de registros em memória interna
+#define MEMORIA_INTERNA 50  // Registros em memória interna sem --mem (tamanho da área de pivôs)
+#define AREA_MAXIMA_QS 1024 // Maior área de pivôs: cada inserção desloca registros da área, então
+                            // uma área maior só compensa nos intervalos ordenados em memória
 
+// Área de pivôs: registros mantidos em memória, ordenados pela chave
+typedef struct {
+    Registro *itens;
+    int n;
+    int capacidade;
+} AreaPivo;
 
-void limpar_arquivos_temporarios() {
-    system("rm -f part_*");  // Para Linux/Unix
-    // system("del /Q part_*"); //Para Windows
+static AreaPivo area;                        // A partição nunca é reentrante
+static Registro *registros_memoria = NULL;   // Intervalos que cabem na memória
+static int tam_memoria_qs = MEMORIA_INTERNA; // Registros em memória, segundo o plano
+
+// Estado de uma partição: um único arquivo lido e escrito pelas duas extremidades
+// Posições são índices de registro (base 0) dentro do arquivo
+typedef struct {
+    Fita *leitura_inf;   // Lê em blocos a partir da extremidade inferior, para cima
+    Fita *escrita_inf;   // Escreve em blocos a partir da extremidade inferior, para cima
+    Fita *leitura_sup;   // Lê em blocos a partir da extremidade superior, para baixo
+    Fita *escrita_sup;   // Escreve em blocos a partir da extremidade superior, para baixo
+    long li, ei;         // Próxima leitura e próxima escrita na extremidade inferior
+    long ls, es;         // Próxima leitura e próxima escrita na extremidade superior
+    int ler_superior;    // Alterna o lado de leitura para manter as duas extremidades equilibradas
+    int ordem;
+    int escreveu_inf;    // 1 se já houve escrita na extremidade inferior
+    int escreveu_sup;    // 1 se já houve escrita na extremidade superior
+    int constante_inf;   // 1 se todas as chaves escritas embaixo são iguais (primeira_inf)
+    int constante_sup;   // 1 se todas as chaves escritas em cima são iguais (primeira_sup)
+    float primeira_inf, primeira_sup;
+} Particao;
+
+// Chave usada nas comparações: a ordem descendente é tratada como ascendente sobre -nota
+static float chave_qs(const Registro *r, int ordem) {
+    return (ordem == ORDEM_ASCENDENTE) ? r->nota : -r->nota;
 }
-// Função que divide o arquivo em dois arquivos menores baseado em um pivô
-void particionar_arquivo(char *arquivo_entrada, char *arquivo_menores, char *arquivo_maiores, float pivo, Metricas* stats) {
-    FILE *entrada = fopen(arquivo_entrada, "rb");
-    FILE *menores = fopen(arquivo_menores, "wb");
-    FILE *maiores = fopen(arquivo_maiores, "wb");
-    
-    if (!entrada || !menores || !maiores) {
-        printf("Erro ao abrir arquivos para particionamento.\n");
-        return;
-    }
-    
-    Registro reg;
-    while (fread(&reg, sizeof(Registro), 1, entrada) == 1) {
-        stats->leituras_pos++;
+
+// Insere um registro na área mantendo-a ordenada pela chave (busca binária)
+static void inserir_area(AreaPivo *area, const Registro *reg, int ordem, Metricas *stats) {
+    float chave = chave_qs(reg, ordem);
+    int esq = 0, dir = area->n;
+    while (esq < dir) {
+        int meio = (esq + dir) / 2;
         stats->comparacoes_pos++;
-        
-        if (reg.nota <= pivo) {
-            fwrite(&reg, sizeof(Registro), 1, menores);
-            stats->escritas_pos++;
+        if (chave_qs(&area->itens[meio], ordem) <= chave) {
+            esq = meio + 1;
         } else {
-            fwrite(&reg, sizeof(Registro), 1, maiores);
-            stats->escritas_pos++;
+            dir = meio;
         }
     }
-    
-    fclose(entrada);
-    fclose(menores);
-    fclose(maiores);
+    memmove(&area->itens[esq + 1], &area->itens[esq], (area->n - esq) * sizeof(Registro));
+    area->itens[esq] = *reg;
+    area->n++;
 }
 
-// Conta o número de registros em um arquivo
-int contar_registros(char *arquivo) {
-    FILE *fp = fopen(arquivo, "rb");
-    if (!fp) return 0;
-    
-    fseek(fp, 0, SEEK_END);
-    long tamanho = ftell(fp);
-    fclose(fp);
-    
-    return tamanho / sizeof(Registro);
+// Remove o registro de menor chave da área
+static Registro retirar_min(AreaPivo *area) {
+    Registro r = area->itens[0];
+    area->n--;
+    memmove(&area->itens[0], &area->itens[1], area->n * sizeof(Registro));
+    return r;
 }
 
-// Função para selecionar um pivô baseado na amostragem de registros
-float selecionar_pivo(char *arquivo, int situacao, Metricas* stats) {
-    int num_registros = contar_registros(arquivo);
-    if (num_registros <= 0) return 0.0;
-    
-    // Define o tamanho da amostra (até MEMORIA_INTERNA registros)
-    int tamanho_amostra = (num_registros < MEMORIA_INTERNA) ? num_registros : MEMORIA_INTERNA;
-    
-    // Aloca memória para a amostra
-    Registro *amostra = (Registro *) malloc(tamanho_amostra * sizeof(Registro));
-    if (!amostra) return 0.0;
-    
-    // Lê uma amostra de registros do arquivo
-    FILE *fp = fopen(arquivo, "rb");
-    if (!fp) {
-        free(amostra);
-        return 0.0;
-    }
-    
-    // Seleciona registros distribuídos pelo arquivo para obter uma boa amostra
-    int intervalo = num_registros / tamanho_amostra;
-    for (int i = 0; i < tamanho_amostra; i++) {
-        fseek(fp, (i * intervalo) * sizeof(Registro), SEEK_SET);
-        fread(&amostra[i], sizeof(Registro), 1, fp);
-        stats->leituras_pos++;
+// Remove o registro de maior chave da área
+static Registro retirar_max(AreaPivo *area) {
+    area->n--;
+    return area->itens[area->n];
+}
+
+// Lê o próximo registro da extremidade superior
+static void ler_sup(Particao *p, Registro *reg, Metricas *stats) {
+    ler_fita(p->leitura_sup, reg);
+    p->ls--;
+    p->ler_superior = 0;
+    stats->leituras_pos++;
+}
+
+// Lê o próximo registro da extremidade inferior
+static void ler_inf(Particao *p, Registro *reg, Metricas *stats) {
+    ler_fita(p->leitura_inf, reg);
+    p->li++;
+    p->ler_superior = 1;
+    stats->leituras_pos++;
+}
+
+// Acompanha se todas as chaves escritas em uma extremidade são iguais
+static void registrar_chave(int *escreveu, int *constante, float *primeira, float chave) {
+    if (!*escreveu) {
+        *escreveu = 1;
+        *constante = 1;
+        *primeira = chave;
+    } else if (chave != *primeira) {
+        *constante = 0;
     }
-    
-    fclose(fp);
-    
-    // Ordena a amostra usando um algoritmo simples
-    for (int i = 0; i < tamanho_amostra - 1; i++) {
-        for (int j = 0; j < tamanho_amostra - i - 1; j++) {
-            stats->comparacoes_pos++;
-            if ((situacao == 1 && amostra[j].nota > amostra[j+1].nota) ||
-                (situacao == 2 && amostra[j].nota < amostra[j+1].nota)) {
-                Registro temp = amostra[j];
-                amostra[j] = amostra[j+1];
-                amostra[j+1] = temp;
-                stats->escritas_pos++;
+}
+
+// Escreve um registro na extremidade superior (registros maiores que a área)
+static void escrever_max(Particao *p, const Registro *reg, Metricas *stats) {
+    registrar_chave(&p->escreveu_sup, &p->constante_sup, &p->primeira_sup, chave_qs(reg, p->ordem));
+    escrever_fita(p->escrita_sup, reg);
+    p->es--;
+    stats->escritas_pos++;
+}
+
+// Escreve um registro na extremidade inferior (registros menores que a área)
+static void escrever_min(Particao *p, const Registro *reg, Metricas *stats) {
+    registrar_chave(&p->escreveu_inf, &p->constante_inf, &p->primeira_inf, chave_qs(reg, p->ordem));
+    escrever_fita(p->escrita_inf, reg);
+    p->ei++;
+    stats->escritas_pos++;
+}
+
+// Particiona o intervalo [esq, dir] do arquivo in-place usando a área de pivôs.
+// Ao final, [esq, *i] contém as chaves menores que a área, [*j, dir] as maiores,
+// e a área ordenada foi gravada entre elas (sem precisar de nova recursão).
+// A partição é de três vias: chaves iguais a um limite da área vão direto para a faixa
+// central daquele lado, sem entrar na área nem estender [esq, *i] ou [*j, dir]; assim a
+// faixa de chaves iguais é escrita uma única vez e nunca volta à recursão. Um lado em
+// que todas as chaves escritas são iguais também é descartado da recursão.
+// Cada extremidade tem sua própria fita de leitura e de escrita com buffer: uma posição só é
+// escrita depois de lida, e nenhuma fita consome posições que outra já tenha sobrescrito.
+static void particionar_area(char *arquivo, long esq, long dir, long *i, long *j,
+                             int ordem, Metricas *stats) {
+    Particao p;
+    Registro ult_lido, r;
+    float lim_inf = 0.0f, lim_sup = 0.0f; // Limites de chave da área
+    int tem_lim_inf = 0, tem_lim_sup = 0;
+    long marca = marcar_arena(); // As quatro fitas da partição saem da arena
+
+    p.leitura_inf = abrir_fita_em(arquivo, FITA_LEITURA, esq, 0, &stats->blocos_lidos_pos);
+    p.escrita_inf = abrir_fita_em(arquivo, FITA_ESCRITA, esq, 0, &stats->blocos_escritos_pos);
+    p.leitura_sup = abrir_fita_em(arquivo, FITA_LEITURA, dir, 1, &stats->blocos_lidos_pos);
+    p.escrita_sup = abrir_fita_em(arquivo, FITA_ESCRITA, dir, 1, &stats->blocos_escritos_pos);
+    limitar_fita(p.leitura_inf, dir - esq + 1);
+    limitar_fita(p.leitura_sup, dir - esq + 1);
+    p.li = p.ei = esq;
+    p.ls = p.es = dir;
+    p.ler_superior = 1;
+    p.ordem = ordem;
+    p.escreveu_inf = p.escreveu_sup = 0;
+    p.constante_inf = p.constante_sup = 0;
+
+    area.n = 0;
+    *i = esq - 1;
+    *j = dir + 1;
+
+    while (p.ls >= p.li) {
+        // Enche a área até sobrar uma vaga
+        if (area.n < area.capacidade - 1) {
+            if (p.ler_superior) {
+                ler_sup(&p, &ult_lido, stats);
+            } else {
+                ler_inf(&p, &ult_lido, stats);
             }
+            inserir_area(&area, &ult_lido, ordem, stats);
+            continue;
         }
-    }
-    
-    // Seleciona o elemento do meio como pivô
-    float pivo = amostra[tamanho_amostra / 2].nota;
-    
-    free(amostra);
-    return pivo;
-}
 
-// Função que une dois arquivos ordenados em um único arquivo ordenado
-void mesclar_arquivos(char *arquivo_saida, char *arquivo1, char *arquivo2, int situacao, Metricas* stats) {
-    FILE *saida = fopen(arquivo_saida, "wb");
-    FILE *f1 = fopen(arquivo1, "rb");
-    FILE *f2 = fopen(arquivo2, "rb");
-    
-    if (!saida || (!f1 && !f2)) {
-        printf("Erro ao abrir arquivos para mesclagem.\n");
-        if (saida) fclose(saida);
-        if (f1) fclose(f1);
-        if (f2) fclose(f2);
-        return;
-    }
-    
-    // Se apenas um dos arquivos existe, copia-o para a saída
-    if (!f1) {
-        Registro reg;
-        while (fread(&reg, sizeof(Registro), 1, f2) == 1) {
-            stats->leituras_pos++;
-            fwrite(&reg, sizeof(Registro), 1, saida);
-            stats->escritas_pos++;
+        // Lê do lado cuja leitura alcançou a escrita, para não sobrescrever dados não lidos
+        if (p.ls == p.es) {
+            ler_sup(&p, &ult_lido, stats);
+        } else if (p.li == p.ei) {
+            ler_inf(&p, &ult_lido, stats);
+        } else if (p.ler_superior) {
+            ler_sup(&p, &ult_lido, stats);
+        } else {
+            ler_inf(&p, &ult_lido, stats);
         }
-        fclose(f2);
-        fclose(saida);
-        return;
-    } else if (!f2) {
-        Registro reg;
-        while (fread(&reg, sizeof(Registro), 1, f1) == 1) {
-            stats->leituras_pos++;
-            fwrite(&reg, sizeof(Registro), 1, saida);
-            stats->escritas_pos++;
+
+        float chave = chave_qs(&ult_lido, ordem);
+        stats->comparacoes_pos++;
+        if (tem_lim_sup && chave > lim_sup) {
+            *j = p.es;
+            escrever_max(&p, &ult_lido, stats);
+            continue;
+        }
+        stats->comparacoes_pos++;
+        if (tem_lim_inf && chave < lim_inf) {
+            *i = p.ei;
+            escrever_min(&p, &ult_lido, stats);
+            continue;
+        }
+
+        // Chave igual a um limite: pertence à faixa já ordenada daquele lado
+        stats->comparacoes_pos++;
+        if (tem_lim_inf && chave == lim_inf) {
+            escrever_min(&p, &ult_lido, stats);
+            continue;
         }
-        fclose(f1);
-        fclose(saida);
-        return;
-    }
-    
-    // Lê o primeiro registro de cada arquivo
-    Registro reg1, reg2;
-    int tem_reg1 = (fread(&reg1, sizeof(Registro), 1, f1) == 1);
-    int tem_reg2 = (fread(&reg2, sizeof(Registro), 1, f2) == 1);
-    stats->leituras_pos += (tem_reg1 + tem_reg2);
-    
-    // Mescla os arquivos
-    while (tem_reg1 && tem_reg2) {
         stats->comparacoes_pos++;
-        int escrever_reg1;
-        
-        if (situacao == 1) { // Ascendente
-            escrever_reg1 = (reg1.nota <= reg2.nota);
-        } else if (situacao == 2) { // Descendente
-            escrever_reg1 = (reg1.nota >= reg2.nota);
-        } else { // Situação aleatória (por simplicidade, mantém ascendente)
-            escrever_reg1 = (reg1.nota <= reg2.nota);
+        if (tem_lim_sup && chave == lim_sup) {
+            escrever_max(&p, &ult_lido, stats);
+            continue;
         }
-        
-        if (escrever_reg1) {
-            fwrite(&reg1, sizeof(Registro), 1, saida);
-            stats->escritas_pos++;
-            tem_reg1 = (fread(&reg1, sizeof(Registro), 1, f1) == 1);
-            if (tem_reg1) stats->leituras_pos++;
+
+        // Cabe na área: insere e devolve um extremo para o lado menos preenchido
+        inserir_area(&area, &ult_lido, ordem, stats);
+        if (p.ei - esq < dir - p.es) {
+            r = retirar_min(&area);
+            escrever_min(&p, &r, stats);
+            lim_inf = chave_qs(&r, ordem);
+            tem_lim_inf = 1;
         } else {
-            fwrite(&reg2, sizeof(Registro), 1, saida);
-            stats->escritas_pos++;
-            tem_reg2 = (fread(&reg2, sizeof(Registro), 1, f2) == 1);
-            if (tem_reg2) stats->leituras_pos++;
+            r = retirar_max(&area);
+            escrever_max(&p, &r, stats);
+            lim_sup = chave_qs(&r, ordem);
+            tem_lim_sup = 1;
         }
     }
-    
-    // Escreve os registros restantes do primeiro arquivo
-    while (tem_reg1) {
-        fwrite(&reg1, sizeof(Registro), 1, saida);
-        stats->escritas_pos++;
-        tem_reg1 = (fread(&reg1, sizeof(Registro), 1, f1) == 1);
-        if (tem_reg1) stats->leituras_pos++;
-    }
-    
-    // Escreve os registros restantes do segundo arquivo
-    while (tem_reg2) {
-        fwrite(&reg2, sizeof(Registro), 1, saida);
-        stats->escritas_pos++;
-        tem_reg2 = (fread(&reg2, sizeof(Registro), 1, f2) == 1);
-        if (tem_reg2) stats->leituras_pos++;
+
+    // Grava a área (já ordenada) no espaço que sobrou entre as duas extremidades
+    while (p.ei <= p.es) {
+        r = retirar_min(&area);
+        escrever_min(&p, &r, stats);
     }
-    
-    fclose(f1);
-    fclose(f2);
-    fclose(saida);
+
+    fechar_fita(p.leitura_inf);
+    fechar_fita(p.escrita_inf);
+    fechar_fita(p.leitura_sup);
+    fechar_fita(p.escrita_sup);
+    restaurar_arena(marca);
+
+    // Subarquivos de chave única já estão ordenados
+    if (p.constante_inf) *i = esq - 1;
+    if (p.constante_sup) *j = dir + 1;
 }
 
-// Implementação recursiva do QuickSort Externo
-void quicksort_externo_recursivo(char *arquivo, int situacao, Metricas* stats) {
-    int num_registros = contar_registros(arquivo);
-    
-    // Caso base: arquivo com 0 ou 1 registro já está ordenado
-    if (num_registros <= 1) {
-        return;
+// Aloca a área de pivôs e o buffer dos intervalos ordenados em memória para 'tam_memoria' registros
+static void preparar_memoria_qs(int tam_memoria) {
+    tam_memoria_qs = tam_memoria;
+    area.capacidade = (tam_memoria < AREA_MAXIMA_QS) ? tam_memoria : AREA_MAXIMA_QS;
+    area.itens = (Registro *)alocar_temporario(area.capacidade * sizeof(Registro));
+    registros_memoria = (Registro *)alocar_temporario(tam_memoria * sizeof(Registro));
+    if (!area.itens || !registros_memoria) {
+        perror("Erro ao alocar memória para o quicksort externo");
+        exit(EXIT_FAILURE);
     }
-    
-    // Caso o número de registros seja pequeno o suficiente para ordenação em memória
-    if (num_registros <= MEMORIA_INTERNA) {
-        // Aloca memória para os registros
-        Registro *registros = (Registro *)malloc(num_registros * sizeof(Registro));
-        if (!registros) {
-            printf("Erro ao alocar memória para ordenação interna.\n");
-            return;
-        }
-        
-        // Lê todos os registros
-        FILE *fp = fopen(arquivo, "rb");
-        if (!fp) {
-            free(registros);
+}
+
+// Devolve a área de pivôs e o buffer de intervalos ao fim da ordenação: reservados da arena,
+// não podem sobreviver à desativação dela
+static void liberar_memoria_qs(void) {
+    liberar_temporario(registros_memoria);
+    liberar_temporario(area.itens);
+    registros_memoria = NULL;
+    area.itens = NULL;
+}
+
+// Ordena em memória o intervalo [esq, dir] do arquivo, que cabe em tam_memoria_qs
+static void ordenar_intervalo_em_memoria(char *arquivo, long esq, long dir, int ordem, Metricas *stats) {
+    Registro *registros = registros_memoria;
+    int n = (int)(dir - esq + 1);
+
+    Fita *leitura = abrir_fita_em(arquivo, FITA_LEITURA, esq, 0, &stats->blocos_lidos_pos);
+    limitar_fita(leitura, n);
+    n = ler_registros_fita(leitura, registros, n);
+    fechar_fita(leitura);
+    stats->leituras_pos += n;
+
+    // Ordena os registros com o núcleo de ordenação interna (pares chave/índice)
+    stats->comparacoes_pos += ordenar_registros(registros, n, ordem);
+
+    // Escreve os registros ordenados de volta no mesmo intervalo
+    Fita *escrita = abrir_fita_em(arquivo, FITA_ESCRITA, esq, 0, &stats->blocos_escritos_pos);
+    escrever_registros_fita(escrita, registros, n);
+    fechar_fita(escrita);
+    stats->escritas_pos += n;
+}
+
+// Implementação recursiva do QuickSort Externo sobre o intervalo [esq, dir] de um único arquivo.
+// Recursão apenas no subarquivo menor; o maior é tratado no próprio laço (pilha O(log n)).
+void quicksort_externo_recursivo(char *arquivo, long esq, long dir, int ordem, Metricas* stats) {
+    if (!registros_memoria) preparar_memoria_qs(tam_memoria_qs);
+    while (dir - esq >= 1) {
+        // Intervalo pequeno o suficiente: ordena em memória com uma leitura e uma escrita
+        if (dir - esq + 1 <= tam_memoria_qs) {
+            ordenar_intervalo_em_memoria(arquivo, esq, dir, ordem, stats);
             return;
         }
-        
-        fread(registros, sizeof(Registro), num_registros, fp);
-        fclose(fp);
-        stats->leituras_pos += num_registros;
-        
-        // Ordena os registros usando o algoritmo interno
-        for (int i = 0; i < num_registros - 1; i++) {
-            for (int j = 0; j < num_registros - i - 1; j++) {
-                stats->comparacoes_pos++;
-                int trocar;
-                
-                if (situacao == 1) { // Ascendente
-                    trocar = (registros[j].nota > registros[j+1].nota);
-                } else if (situacao == 2) { // Descendente
-                    trocar = (registros[j].nota < registros[j+1].nota);
-                } else { // Aleatório (simplificado como ascendente)
-                    trocar = (rand() % 2 == 0);
-                }
-                
-                if (trocar) {
-                    Registro temp = registros[j];
-                    registros[j] = registros[j+1];
-                    registros[j+1] = temp;
-                    stats->escritas_pos++;
-                }
-            }
-        }
-        
-        // Escreve os registros ordenados de volta para o arquivo
-        fp = fopen(arquivo, "wb");
-        if (!fp) {
-            free(registros);
-            return;
+
+        long i, j;
+        particionar_area(arquivo, esq, dir, &i, &j, ordem, stats);
+
+        if (i - esq < dir - j) {
+            quicksort_externo_recursivo(arquivo, esq, i, ordem, stats);
+            esq = j;
+        } else {
+            quicksort_externo_recursivo(arquivo, j, dir, ordem, stats);
+            dir = i;
         }
-        
-        fwrite(registros, sizeof(Registro), num_registros, fp);
-        fclose(fp);
-        stats->escritas_pos += num_registros;
-        
-        free(registros);
-        return;
     }
-    
-    // Seleciona um pivô
-    float pivo = selecionar_pivo(arquivo, situacao, stats);
-    
-    // Cria nomes para arquivos temporários
-    char arquivo_menores[512], arquivo_maiores[512];
-    sprintf(arquivo_menores, "part_menores_%s", strrchr(arquivo, '/') ? strrchr(arquivo, '/') + 1 : arquivo);
-    sprintf(arquivo_maiores, "part_maiores_%s", strrchr(arquivo, '/') ? strrchr(arquivo, '/') + 1 : arquivo);
-    
-    // Particiona o arquivo com base no pivô
-    particionar_arquivo(arquivo, arquivo_menores, arquivo_maiores, pivo, stats);
-    
-    // Ordenação recursiva das partições
-    quicksort_externo_recursivo(arquivo_menores, situacao, stats);
-    quicksort_externo_recursivo(arquivo_maiores, situacao, stats);
-    
-    // Mescla as partições ordenadas
-    mesclar_arquivos(arquivo, arquivo_menores, arquivo_maiores, situacao, stats);
-    
-    // Remove os arquivos temporários
-    remove(arquivo_menores);
-    remove(arquivo_maiores);
 }
 
 // Função principal para executar o QuickSort Externo
-void quicksort_externo(char *arquivo, int quantidade, int situacao, int imprime) {
-    limpar_arquivos_temporarios();
-
-    Metricas stats = {0, 0, 0, 0.0, 0, 0, 0, 0.0};
-    clock_t inicio, fim;
-    
-    char arquivo_temp[100];
-    sprintf(arquivo_temp, "%s_temp", arquivo);
-    
-    // Cria uma cópia do arquivo para trabalhar
-    FILE *entrada = fopen(arquivo, "rb");
-    FILE *temp = fopen(arquivo_temp, "wb");
-    if (!entrada || !temp) {
-        printf("Erro ao abrir arquivos para cópia.\n");
-        if (entrada) fclose(entrada);
-        if (temp) fclose(temp);
-        return;
+// Copia os primeiros 'quantidade' registros para um temporário, o ordena in-place e o exporta
+// para a saída (ARQUIVO_SAIDA_QS ou --saida)
+void quicksort_externo(char *arquivo, int quantidade, int situacao, Metricas *stats, int imprime) {
+    int ordem = ordem_da_situacao(situacao);
+    Cronometro inicio, fim;
+
+    // Plano de memória: intervalos ordenados em memória (registros e pares de ordenação) e as
+    // quatro fitas da partição, além da área de pivôs (no máximo AREA_MAXIMA_QS registros).
+    // Se a memória não passa de AREA_MAXIMA_QS, a área tem um registro por item de memória.
+    RequisitosMemoria req = {MEMORIA_INTERNA, sizeof(Registro) + sizeof(ChaveIndice),
+                             AREA_MAXIMA_QS * sizeof(Registro), 4, 0, 0, 0, 0};
+    PlanoMemoria plano;
+    planejar_memoria(&req, quantidade, &plano, stats);
+    if (plano.memoria < AREA_MAXIMA_QS) {
+        req.bytes_por_item += sizeof(Registro);
+        req.bytes_fixos = 0;
+        planejar_memoria(&req, quantidade, &plano, stats);
     }
-    
+    // A área e o buffer são reservados na primeira partição, depois da cópia ou da pré-análise
+    tam_memoria_qs = plano.memoria;
+
+    // O arquivo de trabalho é um temporário: execuções simultâneas não ordenam o mesmo arquivo
+    char saida[TAM_CAMINHO_TEMPORARIO];
+    int arquivo_saida = preparar_saida(saida);
+
     iniciar_tempo(&inicio);
-    
-    // Copia os primeiros 'quantidade' registros
-    Registro reg;
-    int contador = 0;
-    while (contador < quantidade && fread(&reg, sizeof(Registro), 1, entrada) == 1) {
-        fwrite(&reg, sizeof(Registro), 1, temp);
-        contador++;
-        stats.leituras_pre++;
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): a cópia já é o resultado
+    if (copiar_se_ordenado(arquivo, saida, quantidade, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else if (!ordenar_adaptativo(arquivo, saida, quantidade, plano.memoria, 1, ordem, stats)) {
+        // Cria uma cópia do trecho a ordenar, já que a ordenação é feita no próprio arquivo
+        iniciar_fase(stats, "copia");
+        Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pre);
+        Fita *copia = abrir_fita(saida, FITA_ESCRITA, &stats->blocos_escritos_pre);
+        Registro reg;
+        int contador = 0;
+        while (contador < quantidade && ler_fita(entrada, &reg)) {
+            escrever_fita(copia, &reg);
+            contador++;
+            stats->leituras_pre++;
+            stats->escritas_pre++;
+        }
+        fechar_fita(copia);
+        fechar_fita(entrada);
+
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+        // Executa o quicksort externo (a ordenação in-place preserva o cabeçalho gravado na cópia)
+        iniciar_tempo(&inicio);
+        iniciar_fase(stats, "particao");
+        quicksort_externo_recursivo(saida, 0, contador - 1, ordem, stats);
+        finalizar_fase(stats);
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
     }
-    
-    fclose(entrada);
-    fclose(temp);
-    
-    finalizar_tempo(&inicio, &fim, &stats.tempo_execucao_pre);
-    
-    // Executa o quicksort externo
-    iniciar_tempo(&inicio);
-    quicksort_externo_recursivo(arquivo_temp, situacao, &stats);
-    finalizar_tempo(&inicio, &fim, &stats.tempo_execucao_pos);
-    
+    marcar_ordenado(saida, ordem);
+    liberar_memoria_qs();
+    const char *destino = concluir_saida(arquivo_saida, ARQUIVO_SAIDA_QS);
+
     // Exibe os registros ordenados
     if (imprime == 1) {
-        FILE *resultado = fopen(arquivo_temp, "rb");
-        if (resultado) {
-            while (fread(&reg, sizeof(Registro), 1, resultado) == 1) {
-                print_registro(&reg);
-            }
-            fclose(resultado);
-        }
+        imprimir_binario(destino);
     }
     const char *situacao_txt = (situacao == 1) ? "Ascendente" : (situacao == 2) ? "Descendente" : "Aleatório";
-    log_metricas("QuickSort Externo", quantidade, situacao_txt, stats);
-    
-    // Remove o arquivo temporário
-    remove(arquivo_temp);
-    limpar_arquivos_temporarios();
-
-}
\ No newline at end of file
+    log_metricas("QuickSort Externo", quantidade, situacao_txt, *stats);
+}
@@ -1,8 +1,88 @@
 #include "../include/registro.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 void print_registro(const Registro *r) {
   printf("Inscricao: %08ld, Nota: %5.1f, Estado: %2s, Cidade: %-50s, Curso: %-30s\n",
          r->id, r->nota, r->estado, r->cidade, r->curso);
 }
+
+// Copia um literal para o destino e retorna o ponteiro logo após ele
+static char *copiar_texto(char *p, const char *texto, size_t tam) {
+    memcpy(p, texto, tam);
+    return p + tam;
+}
+
+// Campo de texto com largura mínima: alinhado à direita (%Ns) ou à esquerda (%-Ns)
+static char *formatar_campo(char *p, const char *campo, size_t tam_max, int largura, int esquerda) {
+    size_t tam = strnlen(campo, tam_max);
+    int espacos = (largura > (int)tam) ? largura - (int)tam : 0;
+    if (!esquerda) {
+        memset(p, ' ', espacos);
+        p += espacos;
+    }
+    memcpy(p, campo, tam);
+    p += tam;
+    if (esquerda) {
+        memset(p, ' ', espacos);
+        p += espacos;
+    }
+    return p;
+}
+
+// Inteiro sem sinal em decimal, com zeros à esquerda até 'largura' dígitos
+static char *formatar_inteiro(char *p, unsigned long valor, int largura) {
+    char digitos[24];
+    int n = 0;
+    do {
+        digitos[n++] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+    while (n < largura) digitos[n++] = '0';
+    while (n > 0) *p++ = digitos[--n];
+    return p;
+}
+
+// Nota como %5.1f. Um float convertido para double e multiplicado por 10 é exato (24 + 4 bits
+// de mantissa), então o arredondamento para o décimo mais próximo, com empate para o par,
+// reproduz o do printf. Valores negativos, enormes ou não finitos usam o próprio snprintf.
+static char *formatar_nota(char *p, float nota) {
+    double v = nota;
+    if (signbit(v) || !(v < 1e15)) {
+        return p + snprintf(p, 64, "%5.1f", v); // Até 39 dígitos inteiros
+    }
+    double decimos = v * 10.0;
+    unsigned long d = (unsigned long)decimos;
+    double resto = decimos - (double)d;
+    if (resto > 0.5 || (resto == 0.5 && (d & 1))) d++;
+
+    char texto[24];
+    char *fim = formatar_inteiro(texto, d / 10, 1);
+    *fim++ = '.';
+    *fim++ = (char)('0' + d % 10);
+    int tam = (int)(fim - texto);
+    for (int i = tam; i < 5; i++) *p++ = ' ';
+    return copiar_texto(p, texto, tam);
+}
+
+int formatar_registro(const Registro *r, char *destino) {
+    char *p = destino;
+    p = copiar_texto(p, "Inscricao: ", 11);
+    if (r->id >= 0) {
+        p = formatar_inteiro(p, (unsigned long)r->id, 8);
+    } else {
+        p += snprintf(p, 32, "%08ld", r->id);
+    }
+    p = copiar_texto(p, ", Nota: ", 8);
+    p = formatar_nota(p, r->nota);
+    p = copiar_texto(p, ", Estado: ", 10);
+    p = formatar_campo(p, r->estado, TAM_ESTADO, 2, 0);
+    p = copiar_texto(p, ", Cidade: ", 10);
+    p = formatar_campo(p, r->cidade, TAM_CIDADE, 50, 1);
+    p = copiar_texto(p, ", Curso: ", 9);
+    p = formatar_campo(p, r->curso, TAM_CURSO, 30, 1);
+    *p++ = '\n';
+    return (int)(p - destino);
+}
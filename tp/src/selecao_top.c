@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/selecao_top.h"
+#include "../include/intercalacao2f.h"
+#include "../include/leitura.h"
+#include "../include/fita.h"
+#include "../include/arquivos_temporarios.h"
+#include "../include/arena.h"
+#include "../include/memoria.h"
+
+// Nó do heap de seleção: o campo posicao guarda -(índice na entrada * k + slot), de modo que
+// entre notas iguais o registro mais recente tenha prioridade (fique na raiz e saia primeiro)
+// e o slot do registro em 'guardados' possa ser recuperado
+static int slot_no(const HeapNode *no, int k) {
+    return (int)((-no->posicao) % k);
+}
+
+// Passada de seleção: mantém os k melhores registros da entrada em 'guardados' e o heap
+// correspondente (pior registro na raiz). Retorna quantos registros foram guardados.
+static int selecionar_melhores(const char *arquivo, int quantidade, int k, Registro *guardados,
+                               HeapNode *heap, Metricas *stats, int ordem) {
+    int ordem_inversa = (ordem == ORDEM_ASCENDENTE) ? ORDEM_DESCENDENTE : ORDEM_ASCENDENTE;
+    Fita *entrada = abrir_fita_entrada(arquivo, &stats->blocos_lidos_pre);
+    limitar_fita(entrada, quantidade);
+
+    Registro reg;
+    long lidos = 0;
+    int n = 0;
+    while (ler_fita(entrada, &reg)) {
+        stats->leituras_pre++;
+        if (n < k) {
+            // Heap ainda incompleto: guarda o registro; o heap é construído ao completar
+            guardados[n] = reg;
+            heap[n].nota = reg.nota;
+            heap[n].posicao = -(lidos * k + n);
+            heap[n].ciclo = 0;
+            n++;
+            if (n == k) construir_heap(heap, n, ordem_inversa);
+        } else {
+            // Só entra quem vem estritamente antes do pior guardado; numa nota igual,
+            // o registro guardado apareceu antes na entrada e prevalece
+            stats->comparacoes_pre++;
+            if (quebra_ordem(heap[0].nota, reg.nota, ordem)) {
+                int slot = slot_no(&heap[0], k);
+                guardados[slot] = reg;
+                heap[0].nota = reg.nota;
+                heap[0].posicao = -(lidos * k + slot);
+                descer_no_heap(heap, 0, k, ordem_inversa);
+            }
+        }
+        lidos++;
+    }
+    fechar_fita(entrada);
+
+    if (n < k) construir_heap(heap, n, ordem_inversa);
+    return n;
+}
+
+// Retira do heap os registros do pior para o melhor, preenchendo 'saida' do fim para o início
+static void ordenar_guardados(Registro *guardados, HeapNode *heap, int n, int k, Registro *saida, int ordem) {
+    int ordem_inversa = (ordem == ORDEM_ASCENDENTE) ? ORDEM_DESCENDENTE : ORDEM_ASCENDENTE;
+    for (int tam = n; tam > 0; tam--) {
+        saida[tam - 1] = guardados[slot_no(&heap[0], k)];
+        heap[0] = heap[tam - 1];
+        descer_no_heap(heap, 0, tam - 1, ordem_inversa);
+    }
+}
+
+void selecionar_top(const char *arquivo, int quantidade, int k, int situacao, Metricas *stats, int imprime) {
+    int ordem = ordem_da_situacao(situacao);
+    Cronometro inicio, fim;
+    if (k > quantidade) k = quantidade;
+    int n_k = (k > 0) ? k : 1;
+
+    // A arena comporta os k registros guardados, a saída e o heap, as fitas (a cópia abre
+    // duas) e o bloco e as linhas da impressão
+    ativar_arena();
+    dimensionar_arena((long)n_k * (2 * sizeof(Registro) + sizeof(HeapNode)) + 2 * bytes_fita(sizeof(Registro)) +
+                      (long)registros_por_bloco() * (sizeof(Registro) + TAM_LINHA_REGISTRO) + FOLGA_RESERVAS_PLANO);
+
+    // A saída é preparada em um temporário e só vai para o destino no fim
+    char caminho_saida[TAM_CAMINHO_TEMPORARIO];
+    int temporario_saida = preparar_saida(caminho_saida);
+
+    // Entrada já ordenada na ordem pedida (registrado no cabeçalho): os k primeiros já são a resposta
+    iniciar_tempo(&inicio);
+    if (copiar_se_ordenado(arquivo, caminho_saida, k, ordem, stats)) {
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+    } else {
+        Registro *guardados = (Registro *)alocar_temporario(n_k * sizeof(Registro));
+        Registro *saida = (Registro *)alocar_temporario(n_k * sizeof(Registro));
+        HeapNode *heap = (HeapNode *)alocar_temporario(n_k * sizeof(HeapNode));
+        if (!guardados || !saida || !heap) {
+            perror("Erro ao alocar memória para a seleção");
+            exit(EXIT_FAILURE);
+        }
+
+        iniciar_fase(stats, "selecao");
+        int n = (k > 0) ? selecionar_melhores(arquivo, quantidade, k, guardados, heap, stats, ordem) : 0;
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pre);
+
+        iniciar_tempo(&inicio);
+        iniciar_fase(stats, "saida");
+        ordenar_guardados(guardados, heap, n, k, saida, ordem);
+        Fita *arquivo_saida = abrir_fita(caminho_saida, FITA_ESCRITA, &stats->blocos_escritos_pos);
+        escrever_registros_fita(arquivo_saida, saida, n);
+        fechar_fita(arquivo_saida);
+        stats->escritas_pos += n;
+        finalizar_fase(stats);
+        finalizar_tempo(&inicio, &fim, &stats->tempo_execucao_pos);
+
+        liberar_temporario(heap);
+        liberar_temporario(saida);
+        liberar_temporario(guardados);
+    }
+    marcar_ordenado(caminho_saida, ordem);
+    const char *destino = concluir_saida(temporario_saida, ARQUIVO_SAIDA_TOP);
+
+    const char *ordem_str = (ordem == ORDEM_ASCENDENTE) ? "Ascendente" : "Descendente";
+    char nome_algoritmo[100];
+    sprintf(nome_algoritmo, "Top %d (%s)", k, ordem_str);
+    log_metricas(nome_algoritmo, quantidade, situacao == 1 ? "1" : situacao == 2 ? "2" : "3", *stats);
+
+    // Imprime os registros selecionados, se solicitado
+    if (imprime == 1) {
+        printf("\nRegistros ordenados por nota (ordem %s):\n", ordem_str);
+        imprimir_binario(destino);
+    }
+    desativar_arena();
+}
@@ -3,31 +3,239 @@
 #include <string.h>
 #include <time.h>
 #include "../include/utils.h"
+#include "../include/arena.h"
+#include "../include/arquivos_temporarios.h"
+
+static int formato_metricas = METRICAS_TEXTO;
+static long bytes_lidos = 0;
+static long bytes_escritos = 0;
+
+static void marcar_tempo(Cronometro *c) {
+    clock_gettime(CLOCK_MONOTONIC, &c->parede);
+    c->cpu = clock();
+}
+
+static double segundos_parede(const Cronometro *inicio, const Cronometro *fim) {
+    return (fim->parede.tv_sec - inicio->parede.tv_sec) + (fim->parede.tv_nsec - inicio->parede.tv_nsec) / 1e9;
+}
 
 // Função para iniciar a contagem de tempo
-void iniciar_tempo(clock_t *inicio) {
-    *inicio = clock();
+void iniciar_tempo(Cronometro *inicio) {
+    marcar_tempo(inicio);
 }
 
 // Função para finalizar a contagem de tempo e calcular o tempo de execução
-void finalizar_tempo(clock_t *inicio, clock_t *fim, double *tempo_execucao) {
-    *fim = clock();
-    *tempo_execucao = ((double)(*fim - *inicio)) / CLOCKS_PER_SEC;
+void finalizar_tempo(Cronometro *inicio, Cronometro *fim, double *tempo_execucao) {
+    marcar_tempo(fim);
+    *tempo_execucao = segundos_parede(inicio, fim);
+}
+
+void registrar_tamanho_corrida(Metricas *m, long tamanho) {
+    if (m->num_corridas == 0 || tamanho < m->menor_corrida) m->menor_corrida = tamanho;
+    if (tamanho > m->maior_corrida) m->maior_corrida = tamanho;
+    m->num_corridas++;
+    m->registros_corridas += tamanho;
+}
+
+void registrar_bytes(long lidos, long escritos) {
+    bytes_lidos += lidos;
+    bytes_escritos += escritos;
+}
+
+void consultar_bytes(long *lidos, long *escritos) {
+    *lidos = bytes_lidos;
+    *escritos = bytes_escritos;
+}
+
+// Soma o valor corrente de cada contador à fase, com o sinal indicado
+static void acumular_contadores(Fase *f, const Metricas *m, int sinal) {
+    f->leituras += sinal * (m->leituras_pre + m->leituras_pos);
+    f->escritas += sinal * (m->escritas_pre + m->escritas_pos);
+    f->comparacoes += sinal * (m->comparacoes_pre + m->comparacoes_pos);
+    f->blocos_lidos += sinal * (m->blocos_lidos_pre + m->blocos_lidos_pos);
+    f->blocos_escritos += sinal * (m->blocos_escritos_pre + m->blocos_escritos_pos);
+    f->bytes_lidos += sinal * bytes_lidos;
+    f->bytes_escritos += sinal * bytes_escritos;
+}
+
+void iniciar_fase(Metricas *m, const char *nome) {
+    finalizar_fase(m);
+    if (m->num_fases >= MAX_FASES) return;
+
+    Fase *f = &m->fases[m->num_fases++];
+    memset(f, 0, sizeof(Fase));
+    snprintf(f->nome, TAM_NOME_FASE, "%s", nome);
+    acumular_contadores(f, m, -1);
+    marcar_tempo(&f->inicio);
+    m->fase_aberta = m->num_fases;
+}
+
+void finalizar_fase(Metricas *m) {
+    if (m->fase_aberta == 0) return;
+    Fase *f = &m->fases[m->fase_aberta - 1];
+    Cronometro fim;
+    marcar_tempo(&fim);
+    f->tempo_parede = segundos_parede(&f->inicio, &fim);
+    f->tempo_cpu = (double)(fim.cpu - f->inicio.cpu) / CLOCKS_PER_SEC;
+    acumular_contadores(f, m, 1);
+    m->fase_aberta = 0;
+}
+
+void definir_formato_metricas(int formato) {
+    formato_metricas = formato;
+}
+
+// Imprime 's' entre aspas como string JSON: aspas e barras invertidas escapadas e caracteres
+// de controle como \uXXXX (o diretório temporário vem da linha de comando)
+static void imprimir_string_json(const char *s) {
+    putchar('"');
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            putchar('\\');
+            putchar(c);
+        } else if (c < 0x20) {
+            printf("\\u%04x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+static void log_metricas_json(const char *metodo, int quantidade, const char *situacao, const Metricas *m) {
+    printf("{\"metodo\": \"%s\", \"quantidade\": %d, \"situacao\": \"%s\",\n", metodo, quantidade, situacao);
+    printf(" \"pre\": {\"leituras\": %ld, \"escritas\": %ld, \"blocos_lidos\": %ld, \"blocos_escritos\": %ld, "
+           "\"comparacoes\": %ld, \"tempo\": %.6f},\n",
+           m->leituras_pre, m->escritas_pre, m->blocos_lidos_pre, m->blocos_escritos_pre,
+           m->comparacoes_pre, m->tempo_execucao_pre);
+    printf(" \"pos\": {\"leituras\": %ld, \"escritas\": %ld, \"blocos_lidos\": %ld, \"blocos_escritos\": %ld, "
+           "\"comparacoes\": %ld, \"tempo\": %.6f},\n",
+           m->leituras_pos, m->escritas_pos, m->blocos_lidos_pos, m->blocos_escritos_pos,
+           m->comparacoes_pos, m->tempo_execucao_pos);
+    printf(" \"bytes_lidos\": %ld, \"bytes_escritos\": %ld, \"tempo_cpu\": %.6f,\n",
+           bytes_lidos, bytes_escritos, (double)clock() / CLOCKS_PER_SEC);
+    printf(" \"plano\": {\"orcamento\": %ld, \"memoria\": %d, \"fan_in\": %d, \"bloco\": %d, \"bytes\": %ld},\n",
+           m->memoria_orcamento, m->memoria_plano, m->fan_in_plano, m->bloco_plano, m->bytes_plano);
+    printf(" \"corridas\": {\"quantidade\": %ld, \"registros\": %ld, \"menor\": %ld, \"maior\": %ld},\n",
+           m->num_corridas, m->registros_corridas, m->menor_corrida, m->maior_corrida);
+    long pico_arena, tam_arena, fora_arena;
+    consultar_arena(&pico_arena, &tam_arena, &fora_arena);
+    printf(" \"arena\": {\"tamanho\": %ld, \"pico\": %ld, \"fora\": %ld},\n", tam_arena, pico_arena, fora_arena);
+    long arquivos_criados, bytes_temporarios, pico_temporarios;
+    consultar_arquivos_temporarios(&arquivos_criados, &bytes_temporarios, &pico_temporarios);
+    printf(" \"temporarios\": {\"diretorio\": ");
+    imprimir_string_json(diretorio_temporario());
+    printf(", \"criados\": %ld, \"pico_bytes\": %ld},\n", arquivos_criados, pico_temporarios);
+    printf(" \"fases\": [");
+    for (int i = 0; i < m->num_fases; i++) {
+        const Fase *f = &m->fases[i];
+        printf("%s\n  {\"nome\": \"%s\", \"tempo\": %.6f, \"tempo_cpu\": %.6f, \"leituras\": %ld, \"escritas\": %ld, "
+               "\"comparacoes\": %ld, \"blocos_lidos\": %ld, \"blocos_escritos\": %ld, "
+               "\"bytes_lidos\": %ld, \"bytes_escritos\": %ld}",
+               i > 0 ? "," : "", f->nome, f->tempo_parede, f->tempo_cpu, f->leituras, f->escritas,
+               f->comparacoes, f->blocos_lidos, f->blocos_escritos, f->bytes_lidos, f->bytes_escritos);
+    }
+    printf("]}\n");
+}
+
+static void log_metricas_csv(const char *metodo, int quantidade, const char *situacao, const Metricas *m) {
+    printf("metodo,quantidade,situacao,fase,tempo,tempo_cpu,leituras,escritas,comparacoes,"
+           "blocos_lidos,blocos_escritos,bytes_lidos,bytes_escritos\n");
+    for (int i = 0; i < m->num_fases; i++) {
+        const Fase *f = &m->fases[i];
+        printf("\"%s\",%d,\"%s\",\"%s\",%.6f,%.6f,%ld,%ld,%ld,%ld,%ld,%ld,%ld\n",
+               metodo, quantidade, situacao, f->nome, f->tempo_parede, f->tempo_cpu, f->leituras,
+               f->escritas, f->comparacoes, f->blocos_lidos, f->blocos_escritos, f->bytes_lidos,
+               f->bytes_escritos);
+    }
+    // Pré e pós-processamento (as etapas do relatório em texto): sem tempo de CPU nem bytes próprios
+    printf("\"%s\",%d,\"%s\",\"pre\",%.6f,,%ld,%ld,%ld,%ld,%ld,,\n",
+           metodo, quantidade, situacao, m->tempo_execucao_pre, m->leituras_pre, m->escritas_pre,
+           m->comparacoes_pre, m->blocos_lidos_pre, m->blocos_escritos_pre);
+    printf("\"%s\",%d,\"%s\",\"pos\",%.6f,,%ld,%ld,%ld,%ld,%ld,,\n",
+           metodo, quantidade, situacao, m->tempo_execucao_pos, m->leituras_pos, m->escritas_pos,
+           m->comparacoes_pos, m->blocos_lidos_pos, m->blocos_escritos_pos);
+    printf("\"%s\",%d,\"%s\",\"total\",%.6f,%.6f,%ld,%ld,%ld,%ld,%ld,%ld,%ld\n",
+           metodo, quantidade, situacao, m->tempo_execucao_pre + m->tempo_execucao_pos,
+           (double)clock() / CLOCKS_PER_SEC, m->leituras_pre + m->leituras_pos,
+           m->escritas_pre + m->escritas_pos, m->comparacoes_pre + m->comparacoes_pos,
+           m->blocos_lidos_pre + m->blocos_lidos_pos, m->blocos_escritos_pre + m->blocos_escritos_pos,
+           bytes_lidos, bytes_escritos);
 }
 
 // Função para logar as métricas de pré e pós-processamento
 void log_metricas(const char *metodo, int quantidade, const char *situacao, Metricas m) {
+    finalizar_fase(&m);
+    if (formato_metricas == METRICAS_JSON) {
+        log_metricas_json(metodo, quantidade, situacao, &m);
+        return;
+    }
+    if (formato_metricas == METRICAS_CSV) {
+        log_metricas_csv(metodo, quantidade, situacao, &m);
+        return;
+    }
+
     printf("\nMétricas para o método %s com %d registros na situação %s:\n", metodo, quantidade, situacao);
     
     printf("\nMétricas de Pré-processamento:\n");
-    printf("Leituras: %d\n", m.leituras_pre);
-    printf("Escritas: %d\n", m.escritas_pre);
-    printf("Comparações: %d\n", m.comparacoes_pre);
+    printf("Leituras: %ld\n", m.leituras_pre);
+    printf("Escritas: %ld\n", m.escritas_pre);
+    printf("Blocos lidos: %ld\n", m.blocos_lidos_pre);
+    printf("Blocos escritos: %ld\n", m.blocos_escritos_pre);
+    printf("Comparações: %ld\n", m.comparacoes_pre);
     printf("Tempo de execução: %.6f segundos\n", m.tempo_execucao_pre);
     
     printf("\nMétricas de Pós-processamento:\n");
-    printf("Leituras: %d\n", m.leituras_pos);
-    printf("Escritas: %d\n", m.escritas_pos);
-    printf("Comparações: %d\n", m.comparacoes_pos);
+    printf("Leituras: %ld\n", m.leituras_pos);
+    printf("Escritas: %ld\n", m.escritas_pos);
+    printf("Blocos lidos: %ld\n", m.blocos_lidos_pos);
+    printf("Blocos escritos: %ld\n", m.blocos_escritos_pos);
+    printf("Comparações: %ld\n", m.comparacoes_pos);
     printf("Tempo de execução: %.6f segundos\n", m.tempo_execucao_pos);
+
+    printf("\nBytes lidos: %ld\n", bytes_lidos);
+    printf("Bytes escritos: %ld\n", bytes_escritos);
+    printf("Tempo de CPU: %.6f segundos\n", (double)clock() / CLOCKS_PER_SEC);
+
+    if (m.memoria_plano > 0) {
+        if (m.memoria_orcamento > 0) {
+            printf("\nPlano de memória: orçamento de %ld bytes", m.memoria_orcamento);
+        } else {
+            printf("\nPlano de memória: limites fixos");
+        }
+        printf(", %d itens em memória, fan-in %d, bloco de %d bytes, %ld bytes reservados\n",
+               m.memoria_plano, m.fan_in_plano, m.bloco_plano, m.bytes_plano);
+    }
+
+    if (m.num_corridas > 0) {
+        double media = (double)m.registros_corridas / m.num_corridas;
+        printf("\nCorridas iniciais: %ld, média de %.1f registros (menor %ld, maior %ld)",
+               m.num_corridas, media, m.menor_corrida, m.maior_corrida);
+        // Seleção por substituição em entrada aleatória: cerca de 2 vezes a memória
+        if (m.memoria_plano > 0) printf(", %.2f vezes a memória", media / m.memoria_plano);
+        printf("\n");
+    }
+
+    long pico_arena, tam_arena, fora_arena;
+    consultar_arena(&pico_arena, &tam_arena, &fora_arena);
+    if (tam_arena > 0) {
+        printf("\nArena: pico de %ld de %ld bytes, %ld reservas fora da arena\n", pico_arena, tam_arena, fora_arena);
+    }
+
+    long arquivos_criados, bytes_temporarios, pico_temporarios;
+    consultar_arquivos_temporarios(&arquivos_criados, &bytes_temporarios, &pico_temporarios);
+    if (pico_temporarios > 0) {
+        printf("Arquivos temporários em %s: %ld criados, pico de %ld bytes em disco\n",
+               diretorio_temporario(), arquivos_criados, pico_temporarios);
+    }
+
+    if (m.num_fases > 0) {
+        printf("\nFases:\n");
+        for (int i = 0; i < m.num_fases; i++) {
+            const Fase *f = &m.fases[i];
+            printf("%-20s %10.6f s (CPU %10.6f s) %12ld leituras %12ld escritas %12ld bytes lidos %12ld bytes escritos\n",
+                   f->nome, f->tempo_parede, f->tempo_cpu, f->leituras, f->escritas, f->bytes_lidos, f->bytes_escritos);
+        }
+    }
 }
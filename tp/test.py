@@ -1,12 +1,28 @@
+import csv
 import subprocess
 import matplotlib.pyplot as plt
 
+def ler_metricas_pos(output):
+    """
+    Extrai as leituras e comparações do pós-processamento da saída em CSV (--metricas csv).
+    Retorna None se a linha da etapa "pos" não foi encontrada.
+    """
+    linhas = output.splitlines()
+    # O CSV começa no cabeçalho; antes dele podem vir avisos do método
+    inicio = next((i for i, linha in enumerate(linhas) if linha.startswith("metodo,")), None)
+    if inicio is None:
+        return None
+    for linha in csv.DictReader(linhas[inicio:]):
+        if linha["fase"] == "pos":
+            return {"leituras": int(linha["leituras"]), "comparacoes": int(linha["comparacoes"])}
+    return None
+
 def run_pesquisa(metodo, quantidade, situacao):
     """
     Executa o comando de ordenação no terminal e retorna os dados de pós-processamento.
     """
-    comando = f"./ordena {metodo} {quantidade} {situacao}".strip()
-    arquivo_saida = f"saida_ordena_{quantidade}_registros.txt"
+    comando = f"./ordena {metodo} {quantidade} {situacao} --metricas csv".strip()
+    arquivo_saida = f"saida_ordena_{quantidade}_registros.csv"
     
     try:
         # Executar o comando e redirecionar a saída para o arquivo
@@ -20,37 +36,10 @@ def run_pesquisa(metodo, quantidade, situacao):
         # Depuração: Mostrar a saída bruta para verificar o conteúdo
         print(f"Saída bruta para {quantidade} registros:\n{output}\n{'-'*50}")
         
-        leituras = None
-        comparacoes = None
-        dados = {}
-        in_pos_processamento = False
-
-        # Processar a saída linha por linha
-        for line in output.splitlines():
-            line = line.strip()  # Remove espaços em branco
-            
-            # Identificar o início da seção de pós-processamento
-            if "Métricas de Pós-processamento:" in line:
-                in_pos_processamento = True
-                continue
-            
-            # Extrair apenas se estivermos na seção de pós-processamento
-            if in_pos_processamento:
-                if "Leituras:" in line:
-                    try:
-                        leituras = int(line.split("Leituras:")[1].strip())
-                        dados["leituras"] = leituras
-                    except (IndexError, ValueError) as e:
-                        print(f"Erro ao extrair Leituras em '{line}': {e}")
-                elif "Comparações:" in line:
-                    try:
-                        comparacoes = int(line.split("Comparações:")[1].strip())
-                        dados["comparacoes"] = comparacoes
-                    except (IndexError, ValueError) as e:
-                        print(f"Erro ao extrair Comparações em '{line}': {e}")
+        dados = ler_metricas_pos(output)
         
         # Verificar se os dados foram extraídos corretamente
-        if leituras is None or comparacoes is None:
+        if dados is None:
             raise Exception("Falha ao extrair métricas de pós-processamento.")
         
         return dados
@@ -73,35 +62,15 @@ def gerar_grafico(quantidades):
     has_data = False  # Flag para verificar se há dados a plotar
 
     for quantidade in quantidades:
-        arquivo_saida = f"saida_ordena_{quantidade}_registros.txt"
+        arquivo_saida = f"saida_ordena_{quantidade}_registros.csv"
         
         try:
             with open(arquivo_saida, "r") as f:
                 output = f.read()
             
-            leituras = None
-            comparacoes = None
-            in_pos_processamento = False
-            
-            # Processar a saída linha por linha
-            for line in output.splitlines():
-                line = line.strip()
-                
-                if "Métricas de Pós-processamento:" in line:
-                    in_pos_processamento = True
-                    continue
-                
-                if in_pos_processamento:
-                    if "Leituras:" in line:
-                        try:
-                            leituras = int(line.split("Leituras:")[1].strip())
-                        except (IndexError, ValueError) as e:
-                            print(f"Erro ao extrair Leituras em '{line}' (arquivo {arquivo_saida}): {e}")
-                    elif "Comparações:" in line:
-                        try:
-                            comparacoes = int(line.split("Comparações:")[1].strip())
-                        except (IndexError, ValueError) as e:
-                            print(f"Erro ao extrair Comparações em '{line}' (arquivo {arquivo_saida}): {e}")
+            dados = ler_metricas_pos(output)
+            leituras = dados["leituras"] if dados else None
+            comparacoes = dados["comparacoes"] if dados else None
             
             if leituras is not None and comparacoes is not None:
                 # Plotar a linha para essa quantidade de registros
@@ -147,9 +116,9 @@ def main():
     
     # Solicitar ao usuário a escolha do método
     try:
-        metodo = int(input("Escolha o método (1- 2F Fitas, 2- F + 1 Fitas, 3- Quicksort Externo): "))
+        metodo = int(input("Escolha o método (1- 2F Fitas, 2- F + 1 Fitas, 3- Quicksort Externo, 4- Ordenacao por Etiquetas, 5- Ordenacao por Amostragem, 6- Ordenacao por Contagem): "))
     except ValueError:
-        print("Entrada inválida. Por favor, insira um número entre 1 e 3.")
+        print("Entrada inválida. Por favor, insira um número entre 1 e 6.")
         return
     
     # Mapeamento dos nomes dos métodos
@@ -157,6 +126,9 @@ def main():
         1: "2F Fitas",
         2: "F + 1 Fitas",
         3: "Quicksort Externo",
+        4: "Ordenacao por Etiquetas",
+        5: "Ordenacao por Amostragem",
+        6: "Ordenacao por Contagem",
     }
     
     metodo_nome = metodos_nomes.get(metodo, "Método Desconhecido")